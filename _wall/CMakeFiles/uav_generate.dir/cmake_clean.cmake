@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/uav_generate.dir/tools/uav_generate.cpp.o"
+  "CMakeFiles/uav_generate.dir/tools/uav_generate.cpp.o.d"
+  "uav_generate"
+  "uav_generate.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/uav_generate.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
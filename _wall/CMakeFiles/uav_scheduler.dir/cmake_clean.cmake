@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/uav_scheduler.dir/src/main.cpp.o"
+  "CMakeFiles/uav_scheduler.dir/src/main.cpp.o.d"
+  "uav_scheduler"
+  "uav_scheduler.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/uav_scheduler.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
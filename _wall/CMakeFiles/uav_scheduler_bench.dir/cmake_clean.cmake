@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/uav_scheduler_bench.dir/bench/SearchKernelsBench.cpp.o"
+  "CMakeFiles/uav_scheduler_bench.dir/bench/SearchKernelsBench.cpp.o.d"
+  "uav_scheduler_bench"
+  "uav_scheduler_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/uav_scheduler_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,39 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/BandwidthGrid.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/BandwidthGrid.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/BandwidthGrid.cpp.o.d"
+  "/root/repo/src/BandwidthTimeline.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/BandwidthTimeline.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/BandwidthTimeline.cpp.o.d"
+  "/root/repo/src/Cube.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/Cube.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/Cube.cpp.o.d"
+  "/root/repo/src/CubeOptimizer.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/CubeOptimizer.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/CubeOptimizer.cpp.o.d"
+  "/root/repo/src/DTCube.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/DTCube.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/DTCube.cpp.o.d"
+  "/root/repo/src/DistanceField.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/DistanceField.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/DistanceField.cpp.o.d"
+  "/root/repo/src/Flow.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/Flow.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/Flow.cpp.o.d"
+  "/root/repo/src/FlowState.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/FlowState.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/FlowState.cpp.o.d"
+  "/root/repo/src/InstanceGenerator.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/InstanceGenerator.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/InstanceGenerator.cpp.o.d"
+  "/root/repo/src/Ligne.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/Ligne.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/Ligne.cpp.o.d"
+  "/root/repo/src/LigneFinder.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/LigneFinder.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/LigneFinder.cpp.o.d"
+  "/root/repo/src/Log.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/Log.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/Log.cpp.o.d"
+  "/root/repo/src/Metrics.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/Metrics.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/Metrics.cpp.o.d"
+  "/root/repo/src/Network.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/Network.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/Network.cpp.o.d"
+  "/root/repo/src/Scheduler.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/Scheduler.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/Scheduler.cpp.o.d"
+  "/root/repo/src/ScoreEvaluator.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/ScoreEvaluator.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/ScoreEvaluator.cpp.o.d"
+  "/root/repo/src/Slice.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/Slice.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/Slice.cpp.o.d"
+  "/root/repo/src/SlicePlanner.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/SlicePlanner.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/SlicePlanner.cpp.o.d"
+  "/root/repo/src/ThreadPool.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/ThreadPool.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/ThreadPool.cpp.o.d"
+  "/root/repo/src/UAV.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/UAV.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/UAV.cpp.o.d"
+  "/root/repo/src/Utils.cpp" "CMakeFiles/uav_scheduler_lib.dir/src/Utils.cpp.o" "gcc" "CMakeFiles/uav_scheduler_lib.dir/src/Utils.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,51 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/uav_scheduler_lib.dir/src/BandwidthGrid.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/BandwidthGrid.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/BandwidthTimeline.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/BandwidthTimeline.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Cube.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Cube.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/CubeOptimizer.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/CubeOptimizer.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/DTCube.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/DTCube.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/DistanceField.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/DistanceField.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Flow.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Flow.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/FlowState.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/FlowState.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/InstanceGenerator.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/InstanceGenerator.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Ligne.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Ligne.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/LigneFinder.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/LigneFinder.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Log.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Log.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Metrics.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Metrics.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Network.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Network.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Scheduler.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Scheduler.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/ScoreEvaluator.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/ScoreEvaluator.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Slice.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Slice.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/SlicePlanner.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/SlicePlanner.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/ThreadPool.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/ThreadPool.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/UAV.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/UAV.cpp.o.d"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Utils.cpp.o"
+  "CMakeFiles/uav_scheduler_lib.dir/src/Utils.cpp.o.d"
+  "libuav_scheduler_lib.a"
+  "libuav_scheduler_lib.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/uav_scheduler_lib.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
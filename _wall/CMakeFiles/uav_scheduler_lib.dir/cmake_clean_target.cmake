@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libuav_scheduler_lib.a"
+)
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/uav_score.dir/tools/uav_score.cpp.o"
+  "CMakeFiles/uav_score.dir/tools/uav_score.cpp.o.d"
+  "uav_score"
+  "uav_score.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/uav_score.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
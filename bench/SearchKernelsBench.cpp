@@ -0,0 +1,209 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "CubeOptimizer.h"
+#include "DTCube.h"
+#include "FlowState.h"
+#include "InstanceGenerator.h"
+#include "LigneFinder.h"
+#include "Log.h"
+#include "SlicePlanner.h"
+
+/* ------------------- 分配计数 ------------------- */
+// 替换全套全局 operator new/delete（普通 / 数组 / nothrow / 对齐 / 带尺寸），统计每次迭代的堆分配次数。
+// 分配与释放都经由不内联的 countedAlloc / countedFree，编译器看不到 new 与 free 的直接配对，
+// 对齐分配用 aligned_alloc，同样以 free 释放
+namespace {
+std::atomic<int64_t> g_allocs{0};
+
+[[gnu::noinline]] void* countedAlloc(std::size_t n, std::size_t align) noexcept {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (n == 0) n = 1;
+    if (align <= alignof(std::max_align_t)) return std::malloc(n);
+    return std::aligned_alloc(align, (n + align - 1) / align * align);   // 尺寸须为对齐的整数倍
+}
+
+[[gnu::noinline]] void countedFree(void* p) noexcept { std::free(p); }
+
+void* countedAllocOrThrow(std::size_t n, std::size_t align) {
+    if (void* p = countedAlloc(n, align)) return p;
+    throw std::bad_alloc();
+}
+} // namespace
+
+void* operator new(std::size_t n) { return countedAllocOrThrow(n, 0); }
+void* operator new[](std::size_t n) { return countedAllocOrThrow(n, 0); }
+void* operator new(std::size_t n, std::align_val_t a) { return countedAllocOrThrow(n, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t n, std::align_val_t a) { return countedAllocOrThrow(n, static_cast<std::size_t>(a)); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n, 0); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n, 0); }
+void* operator new(std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept {
+    return countedAlloc(n, static_cast<std::size_t>(a));
+}
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept {
+    return countedAlloc(n, static_cast<std::size_t>(a));
+}
+
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { countedFree(p); }
+
+namespace {
+
+/// 统计计时循环内的分配次数并作为 allocs/iter 上报
+class AllocCounter {
+public:
+    AllocCounter() : start_(g_allocs.load(std::memory_order_relaxed)) {}
+    void report(benchmark::State& state) const {
+        const int64_t n = g_allocs.load(std::memory_order_relaxed) - start_;
+        state.counters["allocs/iter"] =
+            benchmark::Counter(static_cast<double>(n), benchmark::Counter::kAvgIterations);
+    }
+private:
+    int64_t start_;
+};
+
+// 合成实例：相位取 [0,4)，t=4 时路线上的 UAV 带宽均非零（系数 1 或 1/2）；
+// 只开放各流路线两侧 fanout 格，接入点到落地区域距离为 path。
+// A* 枚举的是开放区域内的简单路径，开放格数 ~ path×(2·fanout+1)，扇出稍大即呈指数增长
+// （空旷 10×10 网格单次搜索已超过数秒），参数组合按能在秒级内完成来选取
+Network makeNetwork(int grid, int flows, int path, int fanout, int T = 10) {
+    GeneratorSpec spec;
+    spec.M = spec.N = grid;
+    spec.flows = flows;
+    spec.T = T;
+    spec.distanceMin = spec.distanceMax = path;
+    spec.corridor = fanout;
+    spec.phaseCount = 4;
+    return InstanceGenerator(spec).generate();
+}
+
+/* ------------------- LigneFinder::runAStarOnce ------------------- */
+// 参数：网格边长、路径长度、扇出（路线两侧开放格数）
+void BM_LigneFinder(benchmark::State& state) {
+    const Network net = makeNetwork(static_cast<int>(state.range(0)), 1,
+                                    static_cast<int>(state.range(1)), static_cast<int>(state.range(2)));
+    const Flow& flow = net.flows.front();
+    const int t = 4;
+    const BandwidthGrid& bw = net.bandwidthAt(t);
+
+    size_t candidates = 0;
+    AllocCounter allocs;
+    for (auto _ : state) {
+        LigneFinder finder(net, flow, t, bw, {-1, -1}, {-1, -1}, 0, 1, flow.size);
+        auto result = finder.runAStarOnce();
+        candidates += result.size();
+        benchmark::DoNotOptimize(result.data());
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["candidates"] =
+        benchmark::Counter(static_cast<double>(candidates), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_LigneFinder)
+    ->ArgNames({"grid", "path", "fanout"})
+    ->Args({8, 4, 1})->Args({24, 8, 1})->Args({24, 12, 1})->Args({69, 8, 1})
+    ->Args({69, 16, 0})->Args({69, 64, 0})
+    ->Unit(benchmark::kMicrosecond);
+
+/* ------------------- SlicePlanner::planAllSlices ------------------- */
+// 参数：网格边长、流数、扇出（路径长度固定为 8）
+void BM_SlicePlanner(benchmark::State& state) {
+    const Network net = makeNetwork(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)),
+                                    8, static_cast<int>(state.range(2)));
+    const FlowStateVector flows(net);
+    const int t = 4;
+    const BandwidthGrid& bw = net.bandwidthAt(t);
+
+    size_t slices = 0, hits = 0, lookups = 0;
+    AllocCounter allocs;
+    for (auto _ : state) {
+        SlicePlanner planner(net, flows, t, bw);
+        auto result = planner.planAllSlices();
+        slices += result.size();
+        hits += planner.cacheHits();
+        lookups += planner.cacheHits() + planner.cacheMisses();
+        benchmark::DoNotOptimize(result.data());
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["slices"] =
+        benchmark::Counter(static_cast<double>(slices), benchmark::Counter::kAvgIterations);
+    state.counters["cacheHitRate"] = lookups ? static_cast<double>(hits) / lookups : 0.0;
+}
+BENCHMARK(BM_SlicePlanner)
+    ->ArgNames({"grid", "flows", "fanout"})
+    ->Args({8, 2, 1})->Args({24, 4, 0})->Args({69, 8, 0})->Args({69, 16, 0})
+    ->Unit(benchmark::kMicrosecond);
+
+/* ------------------- DTCubeBuilder::build ------------------- */
+// 参数：网格边长、流数、束宽（每层保留的候选数）；扇出 0、路径长度 8。
+// DFS 在大实例上呈指数增长，只测 Beam
+void BM_DTCubeBuild(benchmark::State& state) {
+    Network net = makeNetwork(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)), 8, 0);
+    CubeBuildOptions options;
+    options.mode = CubeSearchMode::Beam;
+    options.beamWidth = static_cast<int>(state.range(2));
+
+    AllocCounter allocs;
+    for (auto _ : state) {
+        DTCubeBuilder builder(net, options);
+        Cube cube = builder.build();
+        benchmark::DoNotOptimize(cube.slices.data());
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(state.iterations() * net.T);   // 每秒处理的时刻数
+}
+BENCHMARK(BM_DTCubeBuild)
+    ->ArgNames({"grid", "flows", "beam"})
+    ->Args({8, 2, 1})->Args({8, 2, 4})->Args({24, 4, 1})->Args({24, 4, 4})
+    ->Args({69, 8, 4})->Args({69, 16, 2})
+    ->Unit(benchmark::kMillisecond);
+
+/* ------------------- CubeOptimizer::optimize ------------------- */
+// 参数：网格边长、流数；扇出 0、路径长度 8，输入 Cube 由束宽 2 的 Beam 构建，不计入计时
+void BM_CubeOptimizer(benchmark::State& state) {
+    Network net = makeNetwork(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)), 8, 0, 20);
+    CubeBuildOptions options;
+    options.mode = CubeSearchMode::Beam;
+    options.beamWidth = 2;
+    const Cube input = DTCubeBuilder(net, options).build();
+
+    AllocCounter allocs;
+    for (auto _ : state) {
+        CubeOptimizer optimizer(net, input);
+        Cube optimized = optimizer.optimize();
+        benchmark::DoNotOptimize(optimized.slices.data());
+    }
+    allocs.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CubeOptimizer)
+    ->ArgNames({"grid", "flows"})
+    ->Args({8, 2})->Args({24, 4})->Args({69, 8})->Args({69, 16})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Log::setLevel(LogLevel::Warn);   // 计时期间不输出调度日志
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,88 @@
+#ifndef BANDWIDTH_GRID_H
+#define BANDWIDTH_GRID_H
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief BandwidthGrid：M×N 网格上的稠密带宽缓冲区
+ *
+ * - 以 x*N+y 为下标连续存储，替代 std::map<(x,y),double>；
+ * - 越界坐标读取为 0（与旧 map 中“查不到即 0”的语义一致）；
+ * - 拷贝/扣减均为普通数组操作。
+ */
+class BandwidthGrid {
+public:
+    using XY = std::pair<int,int>;
+
+    BandwidthGrid() = default;
+    BandwidthGrid(int M, int N, double init = 0.0);
+
+    int width()  const { return M_; }
+    int height() const { return N_; }
+    int size()   const { return static_cast<int>(data_.size()); }
+
+    bool inGrid(int x, int y) const {
+        return x >= 0 && x < M_ && y >= 0 && y < N_;
+    }
+    int index(int x, int y) const { return x * N_ + y; }
+
+    // 读取 (x,y) 处带宽，越界返回 0
+    double at(int x, int y) const {
+        return inGrid(x, y) ? data_[index(x, y)] : 0.0;
+    }
+    double& operator()(int x, int y) { return data_[index(x, y)]; }
+    double  operator()(int x, int y) const { return data_[index(x, y)]; }
+
+    double*       data()       { return data_.data(); }
+    const double* data() const { return data_.data(); }
+
+    // 全部置为 v
+    void fill(double v);
+
+    // 沿路径扣除 q（下限为 0），路径上越界点忽略
+    void subtractPath(const std::vector<XY>& path, double q);
+
+private:
+    int M_{0};
+    int N_{0};
+    std::vector<double> data_;
+};
+
+/**
+ * @brief BandwidthOverlay：在 BandwidthGrid 上原地扣减并可回滚的残余带宽视图
+ *
+ * - subtractPath() 只改动路径经过的格点，并记录旧值；
+ * - rollback(mark) 按记录逆序恢复到 mark 时的状态（逐位精确）；
+ * - 用于 SlicePlanner 递归枚举时替代“每个候选复制整张带宽表”；
+ * - changedCells() 列出与构造时不同的格点及其当前值（由回滚记录得到，代价与已扣减格数成正比），
+ *   供 SlicePlanner 的 A* 结果缓存精确比较残余带宽。
+ */
+class BandwidthOverlay {
+public:
+    using XY = BandwidthGrid::XY;
+
+    explicit BandwidthOverlay(BandwidthGrid& grid) : grid_(grid) {}
+
+    const BandwidthGrid& grid() const { return grid_; }
+
+    size_t mark() const { return undo_.size(); }
+
+    // 沿路径扣除 q（下限为 0），语义同 BandwidthGrid::subtractPath
+    void subtractPath(const std::vector<XY>& path, double q);
+
+    // 恢复到 mark 时的带宽
+    void rollback(size_t mark);
+
+    // 当前值与构造时不同的格点 (下标, 当前值)，按下标升序写入 out
+    void changedCells(std::vector<std::pair<int,double>>& out) const;
+
+private:
+    BandwidthGrid& grid_;
+    std::vector<std::pair<int,double>> undo_;   // (格点下标, 旧值)
+    mutable std::vector<std::pair<int,double>> scratch_;
+};
+
+#endif // BANDWIDTH_GRID_H
@@ -0,0 +1,36 @@
+#ifndef BANDWIDTH_TIMELINE_H
+#define BANDWIDTH_TIMELINE_H
+
+#include <array>
+#include <vector>
+#include "BandwidthGrid.h"
+#include "UAV.h"
+
+/**
+ * @brief BandwidthTimeline：按 10 秒周期预计算的全网带宽快照
+ *
+ * - b(t) 周期为 10，因此只需保存 10 张 BandwidthGrid；
+ * - 任意时刻 t 的全网带宽即 snapshot[t mod 10]，取用为 O(1)，拷贝为一次 memcpy；
+ * - 由 Network::buildIndex() 在加载完成后构建（内部调用 buildTimeline），经 Network::bandwidthAt() 读取。
+ */
+class BandwidthTimeline {
+public:
+    static constexpr int PERIOD = 10;
+
+    BandwidthTimeline() = default;
+
+    // 根据 UAV 列表构建 10 个相位的快照
+    void build(int M, int N, const std::vector<UAV>& uavs);
+
+    bool empty() const { return snapshots_[0].size() == 0; }
+
+    // 取时刻 t 的全网带宽（t 可为任意非负整数）
+    const BandwidthGrid& at(int t) const {
+        return snapshots_[((t % PERIOD) + PERIOD) % PERIOD];
+    }
+
+private:
+    std::array<BandwidthGrid, PERIOD> snapshots_;
+};
+
+#endif // BANDWIDTH_TIMELINE_H
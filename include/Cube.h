@@ -28,8 +28,8 @@ public:
     // 添加一个 Slice
     void addSlice(const Slice& slice);
 
-    // 输出调试摘要
-    std::string summary() const;
+    // 输出调试摘要（分项与总分按 ScoreEvaluator 的官方评分计算）
+    std::string summary(const Network& net) const;
 };
 
 #endif // CUBE_H
@@ -5,13 +5,19 @@
 #include "Network.h"
 #include "LigneFinder.h"
 #include "SlicePlanner.h"
+#include "BandwidthGrid.h"
+#include "ScoreEvaluator.h"
 #include <map>
+#include <queue>
 #include <vector>
 #include <tuple>
 #include <optional>
 #include <utility>
 #include <iostream>
 
+class ThreadPool;
+class Deadline;
+
 /**
  * @brief CubeOptimizer：对 DTCubeBuilder 产出的 Cube 做“单位得分效率”再平衡优化
  *
@@ -22,10 +28,21 @@
  *  3) 选择 Δeff 最大的流与时刻，从低效时刻 t_low 让出流量到高效时刻 t_high
  *     用 SlicePlanner 在 t_high 层做一次“整层重排”（保留其它流上限/意愿可按需要扩展）
  *  4) 迭代直到没有 Δeff>0
+ *
+ * 潜力表增量维护：每次改动后只重算受影响的 (flow,t) 格——
+ * 切片 t 被改动时该时刻所有流失效；某流在 t 的落点/有无流量变化时 (f,t±1) 失效；
+ * 某流的落点变化次数变化时整行失效。提供线程池时脏格分块并行计算。
+ *
+ * C/P 表为流主序的稠密数组；(gap, 流, 时刻) 候选保存在最大堆中，
+ * 只有 C/P 行发生变化的流才重新生成候选（旧候选按版本号懒删除），选取下一步为 O(log n)。
  */
 class CubeOptimizer {
 public:
-    CubeOptimizer(const Network& net, const Cube& inputCube);
+    // pool 可为空（串行）；由调用方持有，生命周期需覆盖 optimize()
+    // deadline 可为空（不限时）；过期后在下一轮迭代前停止，返回当前（始终合法的）工作副本
+    // nodeBudget 为每次 A* 的节点上限（0 为不限），含义同 CubeBuildOptions::nodeBudget
+    CubeOptimizer(const Network& net, const Cube& inputCube, ThreadPool* pool = nullptr,
+                  const Deadline* deadline = nullptr, size_t nodeBudget = LigneFinder::NO_NODE_BUDGET);
 
     /// 执行优化过程，返回优化后的 Cube
     Cube optimize();
@@ -41,14 +58,54 @@ private:
         bool   valid{false};
         std::pair<int,int> endXY{-1,-1};
     };
-    using Table = std::map<int, std::map<int, CellData>>; // flowId -> (t -> cell)
+
+    /// 流主序稠密表：Network::flows 下标 fi 在时刻 t 的格子位于 cells[fi * T + t]
+    struct Table {
+        int T{0};
+        std::vector<CellData> cells;
+
+        void reset(int flows, int horizon) {
+            T = horizon;
+            cells.assign(static_cast<size_t>(flows) * horizon, CellData{});
+        }
+        CellData&       at(int fi, int t)       { return cells[static_cast<size_t>(fi) * T + t]; }
+        const CellData& at(int fi, int t) const { return cells[static_cast<size_t>(fi) * T + t]; }
+    };
+
+    /// 候选移动：堆顶为 gap 最大者，同分时流下标、时刻较小者优先
+    struct GapCandidate {
+        double   gap;
+        int      fi;
+        int      t;
+        unsigned version;   // 与 flowVersion_[fi] 不同即已过期
+
+        bool operator<(const GapCandidate& o) const {
+            if (gap != o.gap) return gap < o.gap;
+            if (fi != o.fi)   return fi > o.fi;
+            return t > o.t;
+        }
+    };
+    using GapHeap = std::priority_queue<GapCandidate>;
 
     Table confirmedTable_;   // C 表
     Table baselineConfirmedTable_; // 初始 C 表（用于保持原始效率排序）
-    Table potentialTable_;   // P 表
+    Table potentialTable_;   // P 表（并行构建时各格独立写入）
+    std::vector<char> potentialDirty_; // 同 P 表布局：1 表示下次 buildPotentialTable() 需重算
+    std::vector<int>  landingChanges_; // 每流落点变化次数（随 C 表更新）
+
+    GapHeap capacityHeap_;            // 可扩容候选
+    GapHeap replaceHeap_;             // 同时刻纯替换候选（每流至多一个）
+    std::vector<char>     flowDirty_;   // 流的 C/P 行有变化，待重新生成候选
+    std::vector<unsigned> flowVersion_; // 每流候选版本号
+
+    ThreadPool* pool_;
+    ScoreEvaluator evaluator_;        // Debug 日志中逐轮输出官方评分
+    const Deadline* deadline_;
+    size_t nodeBudget_;
+
+    // 潜力表并行构建时每个任务负责的脏格数
+    static constexpr int kPotentialTile = 4;
 
-    // ====== 日志开关（需要静默时改为 false 即可，不影响逻辑）======
-    static constexpr bool LF_DEBUG = true;
     static constexpr double EPS = 1e-9;
 
 private:
@@ -64,14 +121,22 @@ private:
     std::pair<int,int> getLastLanding(int fid, int t) const;
     std::pair<int,int> getNextLanding(int fid, int t) const;
     int  getLandingChangeCountGlobal(int fid) const;
+    int  landingChangeCount(const Table& tbl, int fi) const;
     double getRemainingUntil(int fid, int t) const;
     int  getNeighborState(int fid, int t) const;
 
+    // 脏标记：buildConfirmedTable() 对比新旧 C 表自动标记，改动切片时调用 markSliceDirty()
+    void markPotentialDirty(int fi, int t);
+    void markSliceDirty(int t);
+    void markConfirmedChangesDirty(const Table& previous, const std::vector<int>& previousChanges);
+
     // 在时刻 t 构造“扣除了其它流占用”的带宽矩阵（但对 fid 自身不扣）
-    std::map<std::pair<int,int>, double> makeMaskedBwForPotential(int fid, int t) const;
+    BandwidthGrid makeMaskedBwForPotential(int fid, int t) const;
 
     // 选择 Δeff 最大者：返回 (flowId, t_high, gap, hasCapacityGain)
-    std::tuple<int,int,double,bool> findMaxEfficiencyGap() const;
+    std::tuple<int,int,double,bool> findMaxEfficiencyGap();
+    void refreshGapCandidates();
+    const GapCandidate* liveTop(GapHeap& heap) const;
 
     // 执行一次“从 t_low → t_high 的流量再分配 + t_high 层重排”
     void rebalanceFlow(int fid, int t_high, int t_low);
@@ -7,6 +7,34 @@
 #include "Cube.h"
 #include "Network.h"
 #include "SlicePlanner.h"
+#include "BandwidthGrid.h"
+#include "FlowState.h"
+
+class ThreadPool;
+class Deadline;
+
+/// Cube 构建的搜索方式
+enum class CubeSearchMode {
+    DFS,    ///< 递归决策树（每层最多 20 个候选，最坏 20^T）
+    Beam    ///< 逐层束搜索：每个时刻只保留得分最高的 beamWidth 个状态
+};
+
+/// DTCubeBuilder 的构建参数
+struct CubeBuildOptions {
+    CubeSearchMode mode{CubeSearchMode::DFS};
+    int beamWidth{8};   ///< Beam 模式每层保留的状态数（≥1）
+
+    /// 并行线程池（nullptr 或 size()==1 时串行）；由调用方持有，生命周期需覆盖 build()
+    ThreadPool* pool{nullptr};
+    /// DFS 模式下在前 forkDepth 层把各候选子树分派到线程池
+    int forkDepth{2};
+
+    /// 墙钟截止时间（nullptr 为不限时）；过期后返回已找到的最优完整方案，未规划的尾部时刻贪心补全
+    const Deadline* deadline{nullptr};
+
+    /// 每次 A* 的节点上限（0 为不限，即默认的完备搜索）；显式设置后大网格上内存有界，但可能漏掉部分候选路径
+    size_t nodeBudget{LigneFinder::NO_NODE_BUDGET};
+};
 
 /**
  * @brief 负责生成完整Slice决策树（逐时刻添加 Slice到树上），并将slice树从叶子节点向上逐层提取为Cube。
@@ -18,10 +46,17 @@
  * - 比较各个子节点的 Cube 得分，选择得分最高的 Cube 作为该父节点的最佳 Cube；
  * - 最终形成一个完整的 Cube；
  * - 最终生成的 Cube 包含所有时刻的最优 Slice 组合。
+ * - Beam 模式下改为逐层展开：每个时刻扩展全部存活状态、按累计得分保留前 W 个，
+ *   复杂度 O(T·W·规划代价)，以 beamWidth 在得分与耗时之间取舍。
+ * - 提供线程池时，DFS 前 forkDepth 层的候选子树并行展开，叶子结果汇入共享的最优登记器；
+ *   同分按串行 DFS 的访问顺序决胜，因此结果与串行运行完全一致。
+ * - 设置 deadline 时为随时可停：过期后不再展开新节点；若尚无完整方案，
+ *   则从当前节点起用 SlicePlanner::planGreedySlice() 补全剩余时刻（每次 A* 限节点数），保证总能返回合法 Cube；
+ *   进行中的 A* 也会在过期后停止，返回已找到的落地候选。
  */
 class DTCubeBuilder {
 public:
-    explicit DTCubeBuilder(Network& net);
+    explicit DTCubeBuilder(const Network& net, const CubeBuildOptions& options = CubeBuildOptions{});
 
     /**
      * @brief 构建一个覆盖 [0, T) 所有时刻的 Cube
@@ -30,29 +65,38 @@ public:
 
 private:
     using XY = std::pair<int,int>;
-    Network& network;
+    const Network& network;
     int T;
+    CubeBuildOptions options;
+
+    class BestRegister;
 
-    // 递归搜索
+    Cube buildDfs();
+    Cube buildBeam();
+
+    bool parallel() const;
+
+    // 递归搜索（state 原地修改，子树返回后按撤销日志回滚）
+    // forkPath 为分叉层的候选下标序列，用于并行时的确定性决胜
     void dfs(int t,
              std::vector<Slice>& currentPath,
              double currentScore,
-             double& bestScore,
-             std::vector<Slice>& bestPath,
-             std::map<int,double> remaining,
-             std::map<int,XY>    lastLanding,
-             std::map<int,XY>    nextLanding,
-             std::map<int,int>   changeCount,
-             std::map<int,int>   neighborState);
+             BestRegister& best,
+             FlowStateVector& state,
+             std::vector<int>& forkPath);
+
+    // 时间预算耗尽：从 t 起逐时刻贪心补全 currentPath 并登记为叶子（state / currentPath 调用后还原）
+    void completeGreedily(int t,
+                          std::vector<Slice>& currentPath,
+                          double currentScore,
+                          BestRegister& best,
+                          FlowStateVector& state,
+                          const std::vector<int>& forkPath);
 
     // 工具函数
-    std::map<XY,double> makeBandwidthMap(int t) const;
+    const BandwidthGrid& makeBandwidthGrid(int t) const;
     static double computeSliceScore(const Slice& s);
-    static void   updateStateWithSlice(const Slice& s,
-                                       std::map<int,double>& remaining,
-                                       std::map<int,XY>&    lastLanding,
-                                       std::map<int,int>&   changeCount);
-    static bool   allFinished(const std::map<int,double>& remaining);
+    void          updateStateWithSlice(const Slice& s, FlowStateVector& state) const;
 
     Slice makeEmptySlice(int t) const;
 };
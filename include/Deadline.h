@@ -0,0 +1,53 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <atomic>
+#include <chrono>
+
+/**
+ * @brief Deadline：一次调度共享的墙钟截止时间
+ *
+ * - 默认构造为不限时，expired() 恒为 false 且不读时钟；非正数、NaN 或超过 MAX_SECONDS 的预算同样不限时；
+ * - 一旦过期即锁存，之后各线程读到的结果一致，不会出现“先过期又未过期”；
+ * - 由 Scheduler::run 持有，以指针形式传给 DTCubeBuilder / CubeOptimizer（可为空）。
+ */
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 超过 MAX_SECONDS（约 31 年）的预算视为不限时，避免换算 Clock::duration 时溢出
+    static constexpr double MAX_SECONDS = 1e9;
+
+    Deadline() = default;
+    explicit Deadline(double seconds)
+        : limited_(seconds > 0.0 && seconds <= MAX_SECONDS) {
+        if (limited_)
+            at_ = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                     std::chrono::duration<double>(seconds));
+    }
+
+    Deadline(const Deadline&) = delete;
+    Deadline& operator=(const Deadline&) = delete;
+
+    bool limited() const { return limited_; }
+
+    bool expired() const {
+        if (!limited_) return false;
+        if (expired_.load(std::memory_order_relaxed)) return true;
+        if (Clock::now() < at_) return false;
+        expired_.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    bool limited_{false};
+    Clock::time_point at_{};
+    mutable std::atomic<bool> expired_{false};
+};
+
+// 空指针视为不限时
+inline bool expired(const Deadline* deadline) {
+    return deadline != nullptr && deadline->expired();
+}
+
+#endif // DEADLINE_H
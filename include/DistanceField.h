@@ -0,0 +1,55 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+#include "BandwidthGrid.h"
+#include "BandwidthTimeline.h"
+
+/**
+ * @brief DistanceField：某一带宽快照上各格到落地矩形的最短跳数
+ *
+ * - 以落地矩形内带宽 > 0 的格为源做多源 BFS，只经过带宽 > 0 的格；
+ * - 残余带宽只会把格点变为 0，不会新增可走格，因此对同一时刻的任何残余带宽都是剩余跳数的下界；
+ * - 不可达（含带宽为 0 的格）记为 UNREACHABLE。
+ */
+class DistanceField {
+public:
+    static constexpr uint16_t UNREACHABLE = 0xFFFF;
+
+    DistanceField(const BandwidthGrid& bw, int m1, int n1, int m2, int n2);
+
+    bool reachable(int x, int y) const { return at(x, y) != UNREACHABLE; }
+    uint16_t at(int x, int y) const { return dist_[static_cast<size_t>(x) * N_ + y]; }
+
+    size_t cells() const { return dist_.size(); }
+
+private:
+    int N_;
+    std::vector<uint16_t> dist_;
+};
+
+/**
+ * @brief DistanceFieldCache：按 (落地矩形, 带宽相位) 共享的距离场
+ *
+ * - 带宽时间线周期为 10，同一矩形最多 10 张距离场，首次请求时计算；
+ * - 多线程共享：查找持读锁，BFS 在锁外进行，插入时持写锁（并发的重复计算只保留先插入者）；
+ * - 总格数超过 MAX_CELLS 时清空重来；调用方持有 shared_ptr，清空不影响正在使用的距离场。
+ */
+class DistanceFieldCache {
+public:
+    std::shared_ptr<const DistanceField> get(const BandwidthTimeline& timeline, int t,
+                                             int m1, int n1, int m2, int n2) const;
+
+private:
+    static constexpr size_t MAX_CELLS = size_t(1) << 25;   // 约 64 MB
+
+    mutable std::shared_mutex mutex_;
+    mutable std::unordered_map<uint64_t, std::shared_ptr<const DistanceField>> fields_;
+    mutable size_t cells_{0};
+};
+
+#endif // DISTANCE_FIELD_H
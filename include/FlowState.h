@@ -0,0 +1,59 @@
+#ifndef FLOW_STATE_H
+#define FLOW_STATE_H
+
+#include <vector>
+#include <utility>
+#include "Network.h"
+
+/**
+ * @brief FlowStateVector：按 Network::flows 下标排列的稠密逐流状态
+ *
+ * - 取代 DTCubeBuilder / SlicePlanner 之间传值的五个 std::map<int,...>；
+ * - 决策树搜索时原地修改，修改前写入撤销日志（journal），
+ *   子树返回后 rollback(mark) 即可恢复，内存为 O(流数 + 深度×被改动流数)。
+ */
+class FlowStateVector {
+public:
+    using XY = std::pair<int,int>;
+
+    std::vector<double> remaining;     // 剩余待传流量
+    std::vector<XY>     lastLanding;   // 上一时刻落点（{-1,-1} 表示无）
+    std::vector<XY>     nextLanding;   // 下一时刻落点（{-1,-1} 表示无）
+    std::vector<int>    changeCount;   // 落点变化次数
+    std::vector<int>    neighborState; // 0/1/2 邻接确定程度
+
+    FlowStateVector() = default;
+
+    // 初始状态：remaining=size，落点未知，changeCount=0，neighborState=1
+    explicit FlowStateVector(const Network& net);
+
+    int  size() const { return static_cast<int>(remaining.size()); }
+    bool allFinished() const { return unfinished_ == 0; }
+
+    // 流 idx 在本时刻传输 q 并落在 end：扣减剩余、更新落点与变化次数（写入撤销日志）
+    void consume(int idx, double q, const XY* end);
+
+    // 撤销日志位置；rollback(mark) 恢复到该位置时的状态
+    size_t mark() const { return journal_.size(); }
+    void   rollback(size_t mark);
+
+    // 丢弃全部撤销记录（状态定型，不再回滚时使用，例如束搜索的子状态）
+    void   commit() { journal_.clear(); }
+
+    // 修改过 remaining 后重新统计未完成流数
+    void recount();
+
+private:
+    struct UndoEntry {
+        int    idx;
+        double remaining;
+        XY     lastLanding;
+        int    changeCount;
+    };
+    std::vector<UndoEntry> journal_;
+    int unfinished_{0};
+
+    static bool finished(double r) { return r <= 1e-9; }
+};
+
+#endif // FLOW_STATE_H
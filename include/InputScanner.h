@@ -0,0 +1,67 @@
+#ifndef INPUT_SCANNER_H
+#define INPUT_SCANNER_H
+
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief 输入文本的数字扫描器：以 std::from_chars 逐个读取空白分隔的数值
+ *
+ * 与 istream >> 的切分语义一致（数值之间可为任意空格/换行，接受前导 '+'），
+ * 但不受 locale 影响；数值不完整或夹杂其它字符时抛出带行号的 std::runtime_error。
+ * 输入文件（Network::loadFromBuffer）与输出文件（ScoreEvaluator）共用。
+ */
+class InputScanner {
+public:
+    explicit InputScanner(std::string_view text)
+        : cur_(text.data()), end_(text.data() + text.size()) {}
+
+    template <typename Number>
+    Number next(const char* field) {
+        skipSpace();
+        if (cur_ == end_)
+            fail(field, "unexpected end of input");
+
+        const char* first = (*cur_ == '+') ? cur_ + 1 : cur_;
+        Number value{};
+        auto [ptr, ec] = std::from_chars(first, end_, value);
+        if (ec != std::errc() || (ptr != end_ && !isSpace(*ptr)))
+            fail(field, "malformed value '" + std::string(cur_, tokenEnd()) + "'");
+        cur_ = ptr;
+        return value;
+    }
+
+    // 跳过空白后是否已到文本末尾
+    bool atEnd() {
+        skipSpace();
+        return cur_ == end_;
+    }
+
+private:
+    const char* cur_;
+    const char* end_;
+    int line_{1};
+
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    void skipSpace() {
+        for (; cur_ != end_ && isSpace(*cur_); ++cur_)
+            if (*cur_ == '\n') ++line_;
+    }
+
+    const char* tokenEnd() const {
+        const char* p = cur_;
+        while (p != end_ && !isSpace(*p)) ++p;
+        return p;
+    }
+
+    [[noreturn]] void fail(const char* field, const std::string& what) const {
+        throw std::runtime_error("line " + std::to_string(line_) + ": " + field + ": " + what);
+    }
+};
+
+#endif // INPUT_SCANNER_H
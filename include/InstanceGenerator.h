@@ -0,0 +1,68 @@
+#ifndef INSTANCE_GENERATOR_H
+#define INSTANCE_GENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "Network.h"
+
+/**
+ * @brief 合成实例参数（同一组参数 + seed 总得到同一个实例）
+ *
+ * 题目上限：M,N < 70，FN < 5000，T < 500；maxSpec() 给出贴近上限的一组默认值。
+ * 区间参数均为闭区间 [min, max]；skew 参数按 u^skew（u ∈ [0,1)）映射到区间内，
+ * 1 为均匀分布，>1 偏向区间下端，<1 偏向上端。
+ */
+struct GeneratorSpec {
+    int M{8};
+    int N{8};
+    int T{10};
+    int flows{4};
+    uint32_t seed{42};
+
+    // --- UAV ---
+    int phaseCount{10};       ///< 相位取值 [0, phaseCount)；较小时同一时刻零带宽格点少、网格连通
+    int phaseBlock{1};        ///< 相位按 phaseBlock×phaseBlock 的方块共享（1 为逐 UAV 独立）
+    double bMin{5.0};         ///< 峰值带宽 B 区间（取整）
+    double bMax{20.0};
+    double bSkew{1.0};
+
+    // --- Flow ---
+    int startMax{-1};         ///< 开始时间上限，-1 表示 T/4
+    double startSkew{1.0};    ///< >1 时多数流集中在开头
+    double sizeMin{20.0};     ///< 流量区间（取整）
+    double sizeMax{200.0};
+    int landingMin{3};        ///< 落地区域边长区间
+    int landingMax{3};
+    int distanceMin{-1};      ///< 接入点到落地区域的曼哈顿距离区间；-1 为随机放置
+    int distanceMax{-1};
+    int corridor{-1};         ///< ≥0 时只有各流 L 形路线（先 x 后 y）两侧 corridor 格内的 UAV 有带宽
+
+    // 贴近题目上限的实例：69×69 网格、4999 条流、T=499
+    static GeneratorSpec maxSpec();
+};
+
+/**
+ * @brief InstanceGenerator：按 GeneratorSpec 生成合法的输入实例
+ *
+ * - generate() 返回已建好索引与带宽时间线的 Network，可直接交给调度器 / 基准；
+ * - writeInput() 按输入文件格式写出，Network::loadFromBuffer 可原样读回；
+ * - 随机数只用 mt19937 的原始输出，不依赖标准库分布的实现细节，跨平台结果一致。
+ */
+class InstanceGenerator {
+public:
+    explicit InstanceGenerator(const GeneratorSpec& spec);
+
+    Network generate() const;
+
+    // 写出输入文件格式（首行 M N FN T，随后 M*N 行 UAV、FN 行 Flow）
+    static void writeInput(const Network& net, std::ostream& out);
+
+    // generate() + writeInput() 到文件；打开失败时返回 false
+    bool writeFile(const std::string& path) const;
+
+private:
+    GeneratorSpec spec_;
+};
+
+#endif // INSTANCE_GENERATOR_H
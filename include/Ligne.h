@@ -6,6 +6,7 @@
 #include <utility>
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 /**
  * @brief 单时刻内的一条候选路径（直接作为 A* 的“Item”）
@@ -40,16 +41,14 @@ struct Ligne {
                      int landingX2, int landingY2,
                      double alpha = 0.1);
 
-    // ========== 追加节点 ==========
-    // 只做合法性检查与状态更新（不计算分数）。返回 -1 表示非法，返回 (int)score 表示成功（但分数未刷新）
-    double addPathUav(int x, int y, double q_u);
+    // 纯函数形式的评分：供不持有 Ligne 的搜索节点（LigneFinder 的路径池）复用
+    // Dremain 为未落地时末端到落区的剩余距离估计（已落地时忽略）
+    static double evaluateScore(double Q_total, int t, int t_start, double Tmax,
+                                double q, double distance, bool landed,
+                                double Dremain, double alpha = 0.1);
 
-    // 追加节点并立刻 computeScore，返回最新分数；非法返回 -1
-    double addPathUav(int x, int y, double q_u,
-                   int currentX, int currentY,
-                   int landingX1, int landingY1,
-                   int landingX2, int landingY2,
-                   double alpha = 0.1);
+    // 末端 (x,y) 到落地矩形的曼哈顿距离（在矩形内为 0）
+    static double remainingDistance(int x, int y, int m1, int n1, int m2, int n2);
 
     // ======= 导出标准输出 (t, endX, endY, q) =======
     std::tuple<int,int,int,double> exportOutput() const;
@@ -60,25 +59,26 @@ struct Ligne {
         return score < other.score;
     }
 
-private:
-    // 4 邻接判断
-    static inline bool isNeighbor4(int ax, int ay, int bx, int by) {
-        int dx = std::abs(ax - bx), dy = std::abs(ay - by);
-        return (dx + dy == 1);
-    }
-    // 路径包含该点？
-    static inline bool pathContains(const std::vector<std::pair<int,int>>& path, int x, int y) {
-        for (const auto& p : path) if (p.first == x && p.second == y) return true;
-        return false;
-    }
-    // 是否与除最后一个以外的任一点 4 邻接（避免贴边/绕回）
-    static inline bool adjacentToAnyExceptLast(const std::vector<std::pair<int,int>>& path,
-                                               int x, int y) {
-        if (path.size() <= 1) return false;
-        for (size_t i = 0; i + 1 < path.size(); ++i)
-            if (isNeighbor4(path[i].first, path[i].second, x, y)) return true;
+    /**
+     * @brief 在末端 (lastX,lastY) 之后追加 (x,y) 是否违反成环规则：
+     *  - (x,y) 已在路径中（不允许重复）；
+     *  - (x,y) 与除末端外的任一旧节点 4 邻接（避免贴边/绕回）。
+     * 路径无重复点，因此只需检查 (x,y) 本身及其除末端外的 4 个邻格是否在路径中；
+     * contains(x,y) 为路径成员判定，应为 O(1)（LigneFinder 用按格点的占用标记实现）。
+     */
+    template <class Contains>
+    static bool breaksLoopRule(int x, int y, int lastX, int lastY, Contains&& contains) {
+        if (contains(x, y)) return true;
+        static constexpr int DX[4] = {1, -1, 0, 0};
+        static constexpr int DY[4] = {0, 0, 1, -1};
+        for (int d = 0; d < 4; ++d) {
+            int ax = x + DX[d], ay = y + DY[d];
+            if (ax == lastX && ay == lastY) continue;
+            if (contains(ax, ay)) return true;
+        }
         return false;
     }
+
 };
 
 #endif // LIGNE_H
@@ -4,9 +4,13 @@
 #include "Network.h"
 #include "Flow.h"
 #include "Ligne.h"
+#include "BandwidthGrid.h"
 #include <set>
 #include <map>
 #include <vector>
+#include <cstdint>
+
+class Deadline;
 
 /**
  * @brief LigneFinder：负责在给定时刻 t 搜索某个流的最优路径集合（A* + 动态阈值剪枝）
@@ -15,25 +19,42 @@
  *  - 从网络的带宽矩阵中搜索所有可能落地的路径；
  *  - 结合带宽、路径长度、历史落点变化惩罚，筛选高分候选；
  *  - 提供单次 runAStarOnce() 接口返回候选集合；
+ *  - 可选的节点预算（nodeBudget，默认不限）：调用方显式给出时，达到预算即不再扩展；
+ *  - 给定 deadline 时每出队 DEADLINE_CHECK_POPS 个节点检查一次，过期即停止并返回已找到的落地候选；
+ *
+ * 线程安全：
+ *  - 对 Network、Flow、BandwidthGrid 只读（构造时按 const 引用持有，搜索中不修改）；
+ *  - runAStarOnce() 为 const，搜索节点池 / 路径占用标记为 thread_local，
+ *    因此多个线程可在同一份 Network 与带宽网格上并发运行各自的 LigneFinder。
  */
 class LigneFinder {
 public:
     using XY = std::pair<int,int>;
 
+    // nodeBudget 为 0 表示不限节点数；非 0 时节点池达到该数即不再扩展，返回已找到的候选
+    // （SlicePlanner 的贪心补全，以及命令行 -n 显式开启时）。
+    // 线程局部节点池超过 RETAIN_NODES 个节点的容量时在搜索结束后释放
+    static constexpr size_t NO_NODE_BUDGET = 0;
+    static constexpr size_t RETAIN_NODES   = size_t(1) << 16;
+    static constexpr uint64_t DEADLINE_CHECK_POPS = 256;   // 两次检查 deadline 之间的出队数（2 的幂）
+
     LigneFinder(const Network& net,
                 const Flow& flow,
                 int t,
-                const std::map<XY,double>& bw,
+                const BandwidthGrid& bw,
                 const XY& lastLanding = {-1,-1},
                 const XY& nextLanding = {-1,-1},
                 int landingChangeCount = 0,
                 int neighborState_ = 1,
-                double remainingData = -1)
+                double remainingData = -1,
+                const Deadline* deadline = nullptr,
+                size_t nodeBudget = NO_NODE_BUDGET)
         : network_(net), flow_(flow), t_(t),
           bw_(bw), lastLanding_(lastLanding),nextLanding_(nextLanding),
           landingChangeCount_(landingChangeCount),
           neighborState(neighborState_), 
-          remainingData_(remainingData) {}
+          remainingData_(remainingData),
+          deadline_(deadline), nodeBudget_(nodeBudget) {}
 
     /**
      * @brief 运行一次 A* 搜索，返回候选路径集合
@@ -41,16 +62,55 @@ public:
     std::vector<Ligne> runAStarOnce(const std::set<XY>& banSet = {}) const;
 
 private:
+    /**
+     * @brief A* 搜索节点：只存末端格点与父节点下标，路径由父指针回溯得到
+     * 仅在进入 cmap 的候选上才物化为完整 Ligne。
+     * 成环检查用一份按格点的占用标记，只对应当前被扩展的路径：切换路径时沿父指针
+     * 清除 / 置位两条路径在公共祖先以下的格点，判定为 O(1)。
+     */
+    struct SearchNode {
+        int    x{0}, y{0};
+        int    parent{-1};        // 父节点在路径池中的下标（根为 -1）
+        double q{0.0};            // 瓶颈带宽：沿路径取 min
+        double bandwidth{0.0};
+        int    distance{0};       // 跳数
+        bool   landed{false};
+        double score{0.0};        // 未施加落点奖惩的评分
+    };
+
+    // SearchNode 的父链部分（父下标、格点下标、跳数），与路径池同下标存放；
+    // 切换占用标记时只回溯这份 12 字节的数组，比直接读 SearchNode 更省缓存
+    struct PathLink {
+        int parent;
+        int cell;                 // x*N+y
+        int depth;
+    };
+
+    // 开放集元素：score 高者优先（与 Ligne::operator< 的比较规则一致）
+    struct OpenEntry {
+        double score;
+        int    node;
+        bool operator<(const OpenEntry& other) const { return score < other.score; }
+    };
+
+    // 在末端 (lastX,lastY) 之后追加 (x,y) 是否合法；onPath[x*N+y] 非 0 表示该格在路径上
+    bool canExtend(const uint8_t* onPath, int lastX, int lastY, int x, int y) const;
+
+    // 由路径池中的节点回溯物化为 Ligne（score 为未奖惩分数）
+    Ligne materialize(const std::vector<SearchNode>& pool, int idx, double remainingD) const;
+
     const Network& network_;
     const Flow& flow_;
     int t_;
-    const std::map<XY,double>& bw_;
+    const BandwidthGrid& bw_;
 
     XY lastLanding_;          // 上一次的落点
     XY nextLanding_; 
     int neighborState;        //0：左右都不确定，2：左右都确定
     int landingChangeCount_;  // 落点变化次数
     double remainingData_; 
+    const Deadline* deadline_;   // 可为空（不限时）
+    size_t nodeBudget_;
     // 取指定坐标处的临时带宽
     double bwAt(int x, int y) const;
 
@@ -63,6 +123,9 @@ private:
     // 根据第k次落点变化计算惩罚
     double deltaPenaltyForK(int k) const;
 
+    // 落点 end 相对历史落点的总惩罚
+    double landingPenalty(const XY& end) const;
+
     // 对已落地路径施加奖惩
     void applyLandingAdjustment(Ligne& L) const;
 
@@ -0,0 +1,96 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <sstream>
+#include <string_view>
+
+/// 日志级别（数值越大越详细）
+enum class LogLevel : int {
+    Off = 0,
+    Error,
+    Warn,
+    Info,
+    Debug,
+    Trace
+};
+
+/// 输出日志的模块，各自独立设置运行时级别
+enum class LogModule : int {
+    LigneFinder = 0,
+    SlicePlanner,
+    DTCube,
+    CubeOptimizer,
+    Scheduler,
+    Count
+};
+
+/// 编译期级别上限：高于此级别的日志语句连同判断一起被编译器删除（默认保留到 Debug）
+#ifndef UAV_LOG_MAX_LEVEL
+#define UAV_LOG_MAX_LEVEL 4
+#endif
+
+/**
+ * @brief Log：按模块分级的运行时日志
+ *
+ * - 每个模块一个原子级别，判断只是一次 relaxed load + 比较；
+ * - 语句被关闭时流式参数不会求值（无字符串格式化）；
+ * - 每条记录先写入 Log::Line 的缓冲，析构时在互斥锁下一次写出，
+ *   并行搜索时不同线程的输出不会交错在一行内；
+ * - 默认所有模块为 Info；Error / Warn 写到 std::cerr，其余写到 sink（默认 std::cout）。
+ *
+ * 用法：
+ *   UAV_LOG(CubeOptimizer, Debug) << "gap=" << gap << "\n";
+ *   if (UAV_LOG_ON(CubeOptimizer, Trace)) { Log::Line line(LogLevel::Trace); ...多行... }
+ */
+namespace Log {
+
+extern std::atomic<int> g_levels[static_cast<int>(LogModule::Count)];
+
+inline bool enabled(LogModule module, LogLevel level) {
+    return g_levels[static_cast<int>(module)].load(std::memory_order_relaxed)
+           >= static_cast<int>(level);
+}
+
+void setLevel(LogModule module, LogLevel level);
+void setLevel(LogLevel level);   // 所有模块
+
+// 解析 "info" 或 "warn,optimizer=debug,lignefinder=trace" 形式的配置；无法识别时返回 false 且不做修改
+bool configure(std::string_view spec);
+
+// 非错误日志的输出目标（nullptr 恢复为 std::cout）；调用方保证其生命周期
+void setSink(std::ostream* out);
+
+/// 一条日志记录：缓冲格式化结果，析构时整体写出
+class Line {
+public:
+    explicit Line(LogLevel level) : level_(level) {}
+    ~Line();
+
+    Line(const Line&) = delete;
+    Line& operator=(const Line&) = delete;
+
+    template <typename T>
+    Line& operator<<(const T& value) {
+        buf_ << value;
+        return *this;
+    }
+
+private:
+    LogLevel level_;
+    std::ostringstream buf_;
+};
+
+} // namespace Log
+
+#define UAV_LOG_ON(module, level)                                              \
+    (static_cast<int>(LogLevel::level) <= UAV_LOG_MAX_LEVEL &&                 \
+     Log::enabled(LogModule::module, LogLevel::level))
+
+// 单次 for 而非 if/else：宏内没有 else，放在不加花括号的 if 中也不会与外层 else 错配
+#define UAV_LOG(module, level)                                                 \
+    for (bool uav_log_once_ = UAV_LOG_ON(module, level); uav_log_once_;       \
+         uav_log_once_ = false)                                                \
+        Log::Line(LogLevel::level)
+
+#endif // LOG_H
@@ -0,0 +1,112 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/// 搜索计数器
+enum class MetricCounter : int {
+    AStarRuns = 0,          ///< runAStarOnce 调用次数
+    AStarPops,              ///< 开放集出队
+    AStarPushes,            ///< 开放集入队
+    AStarPrunes,            ///< 低于阈值被剪掉的出队节点
+    AStarBudgetStops,       ///< 达到节点预算而提前停止扩展的搜索次数
+    AStarDeadlineStops,     ///< 时间预算耗尽而提前结束的搜索次数
+    LigneCacheHits,         ///< SlicePlanner 的 A* 结果缓存命中
+    LigneCacheMisses,       ///< 缓存未命中（实际运行 A*）
+    PlanCalls,              ///< planAllSlices 调用次数
+    PlanCandidates,         ///< planAllSlices 返回的 Slice 总数
+    BeamTruncations,        ///< DTCube 候选 / 束被截断的次数
+    BeamDropped,            ///< 截断丢弃的候选数
+    OptimizerIterations,    ///< CubeOptimizer 迭代轮数
+    OptimizerMoves,         ///< CubeOptimizer 实际执行的流量转移
+    Count
+};
+
+/// 计时阶段
+enum class MetricPhase : int {
+    Load = 0,   ///< 读入并解析输入
+    Build,      ///< DTCubeBuilder::build
+    Optimize,   ///< CubeOptimizer::optimize
+    Output,     ///< Scheduler::outputResult
+    Count
+};
+
+/**
+ * @brief Metrics：按调度实例收集的阶段耗时与搜索计数
+ *
+ * - Collector 由调用方持有（例如批处理中每个输入文件一个），用 Metrics::Bind 绑定到当前线程；
+ *   ThreadPool::parallelFor 把调用者绑定的 Collector 传给帮手线程，嵌套并行也计入同一实例；
+ * - 未绑定时 Metrics::current() 为 nullptr，所有统计点只是一次线程局部指针判断；
+ * - 热循环中的计数先累加在局部变量里，每次调用结束时一次性写入（见 LigneFinder::runAStarOnce）。
+ */
+namespace Metrics {
+
+class Collector {
+public:
+    void add(MetricCounter c, uint64_t n = 1) {
+        counters_[static_cast<int>(c)].fetch_add(n, std::memory_order_relaxed);
+    }
+    void addTime(MetricPhase p, std::chrono::nanoseconds d) {
+        phaseNs_[static_cast<int>(p)].fetch_add(d.count(), std::memory_order_relaxed);
+    }
+
+    uint64_t counter(MetricCounter c) const {
+        return counters_[static_cast<int>(c)].load(std::memory_order_relaxed);
+    }
+    double seconds(MetricPhase p) const {
+        return phaseNs_[static_cast<int>(p)].load(std::memory_order_relaxed) * 1e-9;
+    }
+
+    // 写出一个 JSON 对象：{"file":..., "score":..., "phases":{...}, "counters":{...}}
+    void writeJson(std::ostream& out, const std::string& file, double score) const;
+
+private:
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(MetricCounter::Count)> counters_{};
+    std::array<std::atomic<int64_t>,  static_cast<size_t>(MetricPhase::Count)>   phaseNs_{};
+};
+
+extern thread_local Collector* t_current;
+
+// 当前线程绑定的 Collector（未启用时为 nullptr）
+inline Collector* current() { return t_current; }
+
+inline void add(MetricCounter c, uint64_t n = 1) {
+    if (Collector* m = current()) m->add(c, n);
+}
+
+/// 在作用域内把 Collector 绑定到当前线程，析构时恢复原绑定
+class Bind {
+public:
+    explicit Bind(Collector* c) : previous_(t_current) { t_current = c; }
+    ~Bind() { t_current = previous_; }
+    Bind(const Bind&) = delete;
+    Bind& operator=(const Bind&) = delete;
+private:
+    Collector* previous_;
+};
+
+/// 作用域计时：未绑定 Collector 时不读时钟
+class PhaseTimer {
+public:
+    explicit PhaseTimer(MetricPhase phase) : collector_(current()), phase_(phase) {
+        if (collector_) start_ = std::chrono::steady_clock::now();
+    }
+    ~PhaseTimer() {
+        if (collector_) collector_->addTime(phase_, std::chrono::steady_clock::now() - start_);
+    }
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+private:
+    Collector* collector_;
+    MetricPhase phase_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace Metrics
+
+#endif // METRICS_H
@@ -3,8 +3,15 @@
 
 #include <vector>
 #include <iostream>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
 #include "UAV.h"
 #include "Flow.h"
+#include "BandwidthTimeline.h"
+
+class DistanceField;
+class DistanceFieldCache;
 
 class Network {
 public:
@@ -15,14 +22,53 @@ public:
 
     std::vector<UAV> uavs;   // 所有UAV节点
     std::vector<Flow> flows;  // 所有数据流
+    BandwidthTimeline timeline; // 10 个相位的全网带宽快照
 
     Network();
 
-    // 从输入流加载网络拓扑与流信息
+    // 从输入流加载网络拓扑与流信息（整体读入后交给 loadFromBuffer 解析）
     void loadFromInput(std::istream& in);
 
-    // 根据坐标查找UAV
-    const UAV* getUAV(int x, int y) const;
+    // 直接解析内存中的输入文本（可为 mmap 映射区），格式错误时抛出带行号的 std::runtime_error
+    void loadFromBuffer(std::string_view text);
+
+    // 根据当前 uavs 构建带宽时间线（buildIndex 会自动调用）
+    void buildTimeline();
+
+    // 根据当前 uavs / flows 构建坐标→UAV、flowId→下标索引，并重建带宽时间线（loadFromInput 会自动调用）；
+    // 手工构造 Network 或修改 uavs / flows / M / N 后须重新调用，否则查找结果可能过时
+    // （仅元素个数变化时 flowIndex 会退化为线性查找，bandwidthAt 会抛出异常）
+    void buildIndex();
+
+    // 时刻 t 的全网带宽快照（取自 timeline）。所有调度组件统一经由此处读取带宽；
+    // 时间线未构建或与当前 M / N / uavs 个数不符时抛出 std::logic_error
+    const BandwidthGrid& bandwidthAt(int t) const;
+
+    // 时间线是否按当前 M / N / uavs 个数构建
+    bool timelineCurrent() const;
+
+    // 根据坐标查找UAV（O(1)）
+    const UAV* uavAt(int x, int y) const;
+    const UAV* getUAV(int x, int y) const { return uavAt(x, y); }
+
+    // 根据 flowId 查找 Flow / 其在 flows 中的下标（O(1)，不存在返回 nullptr / -1；id 重复时取第一个）
+    const Flow* flowById(int id) const;
+    int flowIndex(int id) const;
+
+    // 时刻 t 的带宽快照上各格到流 f 落地区域的最短跳数（按需计算、线程间共享）；
+    // 时间线未构建或已过时（见 timelineCurrent）时返回空
+    std::shared_ptr<const DistanceField> distanceField(int t, const Flow& f) const;
+
+private:
+    // buildTimeline() 时重建；拷贝的 Network 共享同一缓存（时间线相同）
+    std::shared_ptr<DistanceFieldCache> distanceFields_;
+    bool timelineBuilt_{false};
+    int timelineM_{0}, timelineN_{0};   // 构建时间线时的 M / N / uavs.size()
+    size_t timelineUavs_{0};
+    std::vector<int> uavIndex_;      // x*N+y -> uavs 下标（-1 表示无）
+    std::vector<int> flowIndexById_; // 较小的非负 flowId -> flows 下标（-1 表示无）
+    std::unordered_map<int, int> flowIndexSparse_;   // 其余 flowId -> flows 下标
+    size_t indexedFlows_{0};         // 建索引时的 flows.size()
 };
 
 #endif // NETWORK_H
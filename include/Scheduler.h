@@ -6,22 +6,35 @@
 #include <tuple>
 #include <iostream>
 #include <optional>
+#include <string>
 #include "Network.h"
-#include "Cube.h"  // 暂时直接操作 Cube，不依赖 DTCubeBuilder
+#include "Cube.h"
+#include "DTCube.h"
+
+/// 调度参数（默认值即原有行为：DFS 构建 + 优化）
+struct SchedulerOptions {
+    CubeBuildOptions build;   ///< DTCubeBuilder 的搜索方式 / 束宽
+    int threads{1};           ///< 并行线程数（含调用线程），1 为串行；build.pool 为空时据此建池
+    double timeBudget{0.0};   ///< 单次 run 的墙钟预算（秒），0 为不限；过期后输出当前最优的完整方案
+};
 
 class Scheduler {
 private:
     Network& network;
     std::optional<Cube> resultCube;
+    mutable std::string outputBuffer_;   // outputResult 的格式化缓冲，多次调用复用容量
 
 public:
     explicit Scheduler(Network& net);
 
     // 执行调度算法
-    void run();
+    void run(const SchedulerOptions& options = SchedulerOptions{});
+
+    // 最终 Cube 的官方评分（ScoreEvaluator；未执行调度时为 0）
+    double score() const;
 
-    // 输出结果
-    void outputResult(std::ostream& out) const;
+    // 输出结果：整表格式化进缓冲区后一次写出；echo 为 true 时同时把每条记录打印到 std::cout
+    void outputResult(std::ostream& out, bool echo = false) const;
 };
 
 #endif // SCHEDULER_H
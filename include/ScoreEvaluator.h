@@ -0,0 +1,78 @@
+#ifndef SCORE_EVALUATOR_H
+#define SCORE_EVALUATOR_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Network.h"
+#include "Cube.h"
+
+/// 单个流的官方评分分项
+struct FlowScore {
+    double traffic{0.0};    ///< Total U2G Traffic Score  Σq / Q_total
+    double delay{0.0};      ///< Traffic Delay Score      Σ Tmax/(t-t_start+Tmax) · q/Q_total
+    double distance{0.0};   ///< Transmission Distance    Σ q/Q_total · 2^(-α·曼哈顿距离)
+    int    k{1};            ///< 落点变化数（按时间顺序，初值 1）
+    double total{0.0};      ///< 100 × (0.4·traffic + 0.2·delay + 0.3·distance + 0.1/k)
+};
+
+/// 一次评估的结果
+struct ScoreReport {
+    double total{0.0};              ///< 按 Q_total 加权的总分
+    std::vector<FlowScore> flows;   ///< 按 network.flows 下标
+    int violations{0};              ///< 不合法记录数（仅 validate 时统计）
+    std::string firstViolation;     ///< 第一条不合法记录的说明
+};
+
+/**
+ * @brief ScoreEvaluator：按题目评分公式计算调度方案的得分
+ *
+ * - 按 network.flows 下标维护稠密累加器，对方案做一次线性扫描；
+ *   U2G 得分按实际传输量计算，距离为接入点到落点的曼哈顿距离，落点变化数按记录的时间顺序统计；
+ *   Cube::summary() 的分项也取自 evaluate()；
+ * - score() 只算总分、不做校验，累加器在多次调用间复用，可在搜索 / 优化循环中调用；
+ * - evaluate(..., validate=true) 额外校验：流存在、t ∈ [t_start, T)、落点在落地区域内、
+ *   每个 UAV 每秒的总流量不超过其带宽、流量累计不超过 Q_total；
+ * - 一个实例不可在多个线程间共享（各线程各建一个）。
+ */
+class ScoreEvaluator {
+public:
+    explicit ScoreEvaluator(const Network& net);
+
+    double score(const Cube& cube);
+    ScoreReport evaluate(const Cube& cube, bool validate = true);
+
+    // 解析输出文件文本（"f p" 后接 p 行 "t x y z"）并评分；格式错误时抛出带行号的 std::runtime_error
+    ScoreReport evaluateOutput(std::string_view text, bool validate = true);
+
+private:
+    struct Acc {
+        double sumQ{0.0};
+        int    records{0};
+        double delay{0.0};
+        double distance{0.0};
+        int    k{1};
+        int    lastT{-1};
+        int    lastX{-1}, lastY{-1};
+    };
+
+    void reset(bool validate, double slack);
+    void add(int fi, int t, int x, int y, double q);
+    void flag(const std::string& what);
+    double finishTotal() const;
+    ScoreReport finish();
+
+    const Network& network_;
+    std::vector<Acc> acc_;
+    std::vector<double> usage_;   // validate 时按 (t, x, y) 累计的流量
+    bool validate_{false};
+    double slack_{0.0};           // 每条记录允许的舍入误差（输出文件中 z 保留 1 位小数）
+    int violations_{0};
+    std::string firstViolation_;
+
+    static constexpr double T_MAX = 10.0;
+    static constexpr double ALPHA = 0.1;
+    static constexpr double EPS   = 1e-6;
+};
+
+#endif // SCORE_EVALUATOR_H
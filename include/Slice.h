@@ -5,21 +5,36 @@
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <cstdint>
 
 /**
  * @brief 表示某个时刻的一组路径集合（复合资源分配结果）
  * 
  * Slice 的作用：
  *  - 储存该时刻所有选中的路径 Ligne；
- *  - 判断是否等价（同一批流，得分完全一致）。
+ *  - 判断是否等价（同一批流，按 1e-6 量化后的得分一致）。
  */
 struct Slice {
     int t;                                        // 当前时刻
     std::vector<Ligne> lignes;                    // 当前时刻包含的所有路径
+    uint64_t signature{0};                        // 与顺序无关的 (flowId, 量化得分) 哈希和
 
     Slice(int t_ = 0);
 
-    /// 判断是否等价（同一批流，得分完全一致）
+    /// 递归构建时的压入/弹出（与 recursivePlan 的回溯配对使用），同步维护 signature
+    void pushLigne(const Ligne& L);
+    void popLigne();
+
+    /// 直接改动 lignes 后重新计算 signature
+    void recomputeSignature();
+
+    /// 得分按 1e-6 量化（signature 与 isSameAs 共用）
+    static long long quantizedScore(double score);
+
+    /// 单条 Ligne 对 signature 的贡献：flowId 与量化得分
+    static uint64_t ligneHash(const Ligne& L);
+
+    /// 判断是否等价（同一批流，量化得分逐一相同）
     bool isSameAs(const Slice& other) const;
 
     /// 输出调试信息
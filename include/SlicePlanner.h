@@ -2,39 +2,105 @@
 #include "Network.h"
 #include "LigneFinder.h"
 #include "Slice.h"
+#include "BandwidthGrid.h"
+#include "FlowState.h"
 #include <map>
+#include <memory>
 #include <vector>
+#include <unordered_map>
+
+class ThreadPool;
+class Deadline;
 
 class SlicePlanner {
 public:
     using XY = std::pair<int,int>;
 
     SlicePlanner(const Network& net,
-        const std::map<int, double>& remaining,
-        const std::map<int, XY>& lastLanding,
-        const std::map<int, XY>& nextLanding,
-        const std::map<int, int>& changeCount,
-        const std::map<int, int>& neighborState,
+        const FlowStateVector& state,
         int t,
-        const std::map<XY, double>& bw);
+        const BandwidthGrid& bw,
+        ThreadPool* pool = nullptr,
+        const Deadline* deadline = nullptr,
+        size_t nodeBudget = LigneFinder::NO_NODE_BUDGET);
+
+    // residual_ 引用自身的 bw_，禁止拷贝
+    SlicePlanner(const SlicePlanner&) = delete;
+    SlicePlanner& operator=(const SlicePlanner&) = delete;
 
     std::vector<Slice> planAllSlices();
 
+    // 贪心单切片：按流下标依次为每条未完成的流取 A* 最优路线并扣减带宽，
+    // 代价为每流一次 A*；用于时间预算耗尽后补全剩余时刻。
+    // deadline 已过期时每次 A* 至多 GREEDY_NODE_BUDGET 个节点（不再受 deadline 截断），
+    // 找不到落地路线的流本时刻留空
+    Slice planGreedySlice();
+
+    // 本规划器内 A* 结果缓存的命中 / 未命中次数
+    int cacheHits()   const { return cacheHits_; }
+    int cacheMisses() const { return cacheMisses_; }
+
 private:
-    std::vector<std::vector<int>> computeFlowOrder() const;
+    // 各流的 A* 评估互不依赖；有线程池时并行执行，结果按流下标收集后再排序（同时填充 A* 缓存）
+    std::vector<std::vector<int>> computeFlowOrder();
+
+    /**
+     * A* 结果缓存：键为 (流, 落点上下文, 该流可触及区域内的残余带宽改动)。
+     * computeFlowOrder 与 recursivePlan 首个流、以及 ≤4 流全排列的公共前缀会在相同带宽与上下文上
+     * 重复搜索同一条流，命中时直接复用候选集。
+     * - 可触及区域为起点在 bw_ 正带宽格上的 4 连通分量：残余带宽只减不增，A* 读到的非零格都在其中，
+     *   区域外的扣减不影响结果，因此只把区域内被扣减过的格点 (下标, 残余值) 放入键并逐一精确比较；
+     * - 条目以 shared_ptr 持有，超过 MAX_CACHE_ENTRIES 时整体清空，调用方手中的候选集不受影响。
+     */
+    struct SearchKey {
+        int flow;
+        XY lastLanding, nextLanding;
+        int changeCount, neighborState;
+        double remaining;
+        std::vector<std::pair<int,double>> cells;   // 按下标升序
+        uint64_t cellsHash;
+        bool operator==(const SearchKey& o) const {
+            return flow == o.flow && cellsHash == o.cellsHash && remaining == o.remaining
+                && lastLanding == o.lastLanding && nextLanding == o.nextLanding
+                && changeCount == o.changeCount && neighborState == o.neighborState
+                && cells == o.cells;
+        }
+    };
+    struct SearchKeyHash {
+        size_t operator()(const SearchKey& k) const;
+    };
+    static constexpr size_t GREEDY_NODE_BUDGET = 256;
+    static constexpr size_t MAX_CACHE_ENTRIES = 4096;
+
+    using LigneList = std::shared_ptr<const std::vector<Ligne>>;
+
+    SearchKey searchKey(int idx) const;
+    std::vector<Ligne> runFinder(int idx) const;   // 在当前残余带宽上为第 idx 条流跑一次 A*（受 deadline_ / nodeBudget_ 约束）
+    std::vector<Ligne> runCappedFinder(int idx) const;   // 同上，但不看 deadline、节点数限 GREEDY_NODE_BUDGET
+    LigneList findLignes(int idx);                 // 带缓存的 runFinder
+    void cacheStore(SearchKey key, LigneList lignes);
+
+    std::unordered_map<SearchKey, LigneList, SearchKeyHash> searchCache_;
+    std::vector<int> component_;                   // bw_ 正带宽格的 4 连通分量编号（-1 为零带宽格）
+    mutable std::vector<std::pair<int,double>> changed_;   // searchKey 的临时缓冲
+    int cacheHits_{0};
+    int cacheMisses_{0};
 
     const Network& network_;
-    std::map<int, double> remaining_;
-    std::map<int, XY> lastLanding_;
-    std::map<int, XY> nextLanding_;
-    std::map<int, int> changeCount_;
-    std::map<int, int> neighborState_;  
+    const FlowStateVector& state_;   // 按 flows 下标排列的逐流状态（只读）
     int t_;
-    std::map<XY, double> bw_;
+    BandwidthGrid bw_;
+    BandwidthOverlay residual_;   // bw_ 上的残余带宽视图（递归时原地扣减/回滚）
+    ThreadPool* pool_;            // 可为空（串行）
+    const Deadline* deadline_;    // 可为空（不限时）；过期后停止枚举，返回已生成的 Slice
+    size_t nodeBudget_;           // 传给 runFinder 的 A* 节点上限（0 为不限）
+
+    // 按 signature 去重：仅在哈希相同时才做完整 isSameAs 比较
+    std::unordered_multimap<uint64_t, size_t> seenSignatures_;
+    bool addIfNew(const Slice& s, std::vector<Slice>& allSlices);
 
     void recursivePlan(int index,
                        const std::vector<int>& flowOrder,
-                       std::map<XY, double> currentBw,
-                       Slice currentSlice,
+                       Slice& currentSlice,
                        std::vector<Slice>& allSlices);
 };
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief ThreadPool：固定线程数的简单线程池，只提供 parallelFor
+ *
+ * - 调用者线程也参与执行（“共 size() 个线程”中包含调用者），
+ *   因此在任务内部再次调用 parallelFor（嵌套并行）不会死锁；
+ * - size() <= 1 时退化为在调用线程上顺序执行，行为与串行代码完全一致；
+ * - 任务抛出的第一个异常会在 parallelFor 返回前于调用线程重新抛出。
+ */
+class ThreadPool {
+public:
+    // threads 为并行度（含调用线程），<=1 表示不创建工作线程
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers_.size()) + 1; }
+
+    // 对 i ∈ [0, n) 并行调用 fn(i)，全部完成后返回；下标之间不保证执行顺序
+    void parallelFor(int n, const std::function<void(int)>& fn);
+
+    // 机器可用的硬件线程数（至少 1）
+    static int hardwareThreads();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_{false};
+};
+
+#endif // THREAD_POOL_H
@@ -16,6 +16,10 @@ public:
 
     // 获取该UAV在t秒时刻的带宽（根据题目周期模型）
     double bandwidthAt(int t) const;
+
+    // 周期内各相位的带宽系数：0,1,8,9 -> 0；2,7 -> 1/2；3~6 -> 1
+    static constexpr double PHASE_FACTOR[10] = {0.0, 0.0, 0.5, 1.0, 1.0,
+                                                1.0, 1.0, 0.5, 0.0, 0.0};
 };
 
 #endif // UAV_H
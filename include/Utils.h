@@ -1,10 +1,12 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <ostream>
 #include <string>
 #include <vector>
 #include "Network.h"
 #include "Scheduler.h"
+#include "ScoreEvaluator.h"
 
 namespace Utils {
 
@@ -14,6 +16,9 @@ namespace Utils {
     // 读取单个输入文件为 Network 对象
     bool loadNetworkFromFile(const std::string& inputPath, Network& network);
 
+    // 按题目评分公式评估已保存的输出文件（无法打开或格式错误时返回 false）
+    bool scoreOutputFile(const Network& network, const std::string& outputPath, ScoreReport& report);
+
     // 运行调度并输出结果到指定路径
     bool runSchedulerAndSave(const Network& network, const std::string& outputPath);
 
@@ -21,6 +26,35 @@ namespace Utils {
     std::string makeOutputPath(const std::string& inputPath,
                                const std::string& inputDir,
                                const std::string& outputDir);
+
+    // 构造 metrics 报告路径（intput/xxx.txt → output/xxx_metrics.json）
+    std::string makeMetricsPath(const std::string& inputPath, const std::string& outputDir);
+
+    /// 批处理参数
+    struct BatchOptions {
+        std::string inputDir{"../input"};
+        std::string outputDir{"../output"};
+        int workers{1};               ///< 同时调度的实例数（含调用线程）
+        bool metrics{false};          ///< 为每个实例写出 xxx_metrics.json（阶段耗时与搜索计数）
+        SchedulerOptions scheduler;   ///< 每个实例的调度参数
+    };
+
+    /// 单个输入文件的处理结果
+    struct BatchResult {
+        std::string inputPath;
+        std::string outputPath;
+        bool   ok{false};
+        double seconds{0.0};   ///< 读入 + 调度 + 写出的墙钟时间
+        double score{0.0};     ///< Scheduler::score()
+    };
+
+    // 调度 inputDir 下的全部文件：各实例独立持有 Network / Scheduler，
+    // 由 workers 个线程并发处理；结果按文件名排序返回
+    std::vector<BatchResult> runBatch(const BatchOptions& options);
+
+    // 打印逐文件耗时 / 得分汇总表
+    void printBatchReport(const std::vector<BatchResult>& results,
+                          double wallSeconds, std::ostream& out);
 }
 
 #endif // UTILS_H
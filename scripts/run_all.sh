@@ -23,4 +23,4 @@ if [[ ! -x "${TARGET}" ]]; then
     exit 1
 fi
 
-(cd "${BUILD_DIR}" && ./uav_scheduler)
+"${TARGET}" -i "${INPUT_DIR}" -o "${OUTPUT_DIR}" "$@"
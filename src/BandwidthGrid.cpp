@@ -0,0 +1,50 @@
+#include "BandwidthGrid.h"
+#include <algorithm>
+
+BandwidthGrid::BandwidthGrid(int M, int N, double init)
+    : M_(M), N_(N), data_(static_cast<size_t>(std::max(0, M * N)), init) {}
+
+void BandwidthGrid::fill(double v) {
+    std::fill(data_.begin(), data_.end(), v);
+}
+
+void BandwidthGrid::subtractPath(const std::vector<XY>& path, double q) {
+    for (const auto& [x, y] : path) {
+        if (!inGrid(x, y)) continue;
+        double& b = data_[index(x, y)];
+        b = std::max(0.0, b - q);
+    }
+}
+
+void BandwidthOverlay::subtractPath(const std::vector<XY>& path, double q) {
+    double* data = grid_.data();
+    for (const auto& [x, y] : path) {
+        if (!grid_.inGrid(x, y)) continue;
+        const int idx = grid_.index(x, y);
+        undo_.emplace_back(idx, data[idx]);
+        data[idx] = std::max(0.0, data[idx] - q);
+    }
+}
+
+void BandwidthOverlay::rollback(size_t mark) {
+    double* data = grid_.data();
+    while (undo_.size() > mark) {
+        const auto [idx, old] = undo_.back();
+        data[idx] = old;
+        undo_.pop_back();
+    }
+}
+
+void BandwidthOverlay::changedCells(std::vector<std::pair<int,double>>& out) const {
+    out.clear();
+    // 同一格可能被记录多次，最早的记录即构造时的值
+    scratch_.assign(undo_.begin(), undo_.end());
+    std::stable_sort(scratch_.begin(), scratch_.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    const double* data = grid_.data();
+    for (size_t i = 0; i < scratch_.size(); ) {
+        const auto [idx, base] = scratch_[i];
+        if (data[idx] != base) out.emplace_back(idx, data[idx]);
+        while (i < scratch_.size() && scratch_[i].first == idx) ++i;
+    }
+}
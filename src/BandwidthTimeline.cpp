@@ -0,0 +1,11 @@
+#include "BandwidthTimeline.h"
+
+void BandwidthTimeline::build(int M, int N, const std::vector<UAV>& uavs) {
+    for (int p = 0; p < PERIOD; ++p) {
+        BandwidthGrid& g = snapshots_[p];
+        g = BandwidthGrid(M, N);
+        for (const auto& u : uavs) {
+            if (g.inGrid(u.x, u.y)) g(u.x, u.y) = u.bandwidthAt(p);
+        }
+    }
+}
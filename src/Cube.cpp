@@ -1,10 +1,10 @@
 #include "Cube.h"
+#include "ScoreEvaluator.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <map>
-#include <numeric>
-#include <cmath>
+#include <algorithm>
 
 Cube::Cube(int T)
     : T(T), totalScore(0.0) {}
@@ -23,100 +23,76 @@ void Cube::addSlice(const Slice& slice) {
 }
 
 
-std::string Cube::summary() const {
-    std::ostringstream oss;
-    oss << "Scoring Calculation\n";
+namespace {
 
-    // === 汇总每个 flow 的 Ligne ===
-    std::map<int, std::vector<Ligne>> flowMap;
+// 汇总每个 flow 的 Ligne（按时间顺序）
+std::map<int, std::vector<const Ligne*>> groupByFlow(const std::vector<Slice>& slices) {
+    std::map<int, std::vector<const Ligne*>> flowMap;
     for (const auto& s : slices) {
         for (const auto& L : s.lignes) {
-            flowMap[L.flowId].push_back(L);
+            flowMap[L.flowId].push_back(&L);
         }
     }
+    return flowMap;
+}
 
-    double totalWeighted = 0.0;
-    double totalSize = 0.0;
-
-    // === 按 flow 输出 ===
-    for (const auto& [fid, lignes] : flowMap) {
-        if (lignes.empty()) continue;
-
-        const double Q_total = lignes.front().Q_total;
-        totalSize += Q_total;
-
-        double U2G_Score = 1.0;  // 所有流已全部传输
-
-        // 平均时延得分估计（参考老师例）
-        double delaySum = 0.0;
-        for (const auto& L : lignes) {
-            int delayFactor = std::max(0, L.t - L.t_start);
-            delaySum += (L.Tmax / (delayFactor + L.Tmax)) * (L.q / Q_total);
-        }
-        double TrafficDelayScore = delaySum;
+} // namespace
 
-        // 距离得分
-        double DistScore = 0.0;
-        for (const auto& L : lignes) {
-            DistScore += (L.q / Q_total) * std::pow(2.0, -0.1 * L.distance);
-        }
+/**
+ * @brief 调试摘要：各流分项取自 ScoreEvaluator::evaluate()，末行总分与官方得分一致
+ */
+std::string Cube::summary(const Network& net) const {
+    std::ostringstream oss;
+    oss << "Scoring Calculation\n";
 
-        // 落点变化数 k：若所有 Ligne 落点相同则 k=1，否则按落点变化+1
-        int k = 1;
-        std::pair<int,int> lastEnd = lignes.front().pathXY.back();
-        for (const auto& L : lignes) {
-            auto end = L.pathXY.back();
-            if (end != lastEnd) {
-                k++;
-                lastEnd = end;
-            }
-        }
-        double U2GPointScore = 1.0 / k;
+    const ScoreReport report = ScoreEvaluator(net).evaluate(*this, false);
+    const auto flowMap = groupByFlow(slices);
+    static const std::vector<const Ligne*> noLignes;
 
-        // 计算总分
-        double totalScore = 100.0 * (0.4 * U2G_Score +
-                                     0.2 * TrafficDelayScore +
-                                     0.3 * DistScore +
-                                     0.1 * U2GPointScore);
+    // === 按 flow 输出 ===
+    for (size_t fi = 0; fi < net.flows.size(); ++fi) {
+        const Flow& flow = net.flows[fi];
+        if (flow.size <= 0.0) continue;
+        const FlowScore& fs = report.flows[fi];
+        const double Q_total = flow.size;
+        const double U2GPointScore = 1.0 / fs.k;
+        auto it = flowMap.find(flow.id);
+        const auto& lignes = it != flowMap.end() ? it->second : noLignes;
 
         // 打印细节
-        oss << "\nFlow " << fid << ":\n";
+        oss << "\nFlow " << flow.id << ":\n";
         oss << "• Total U2G Traffic Score = "
             << std::fixed << std::setprecision(1)
-            << Q_total << "/" << Q_total << " = 1.0\n\n";
+            << fs.traffic * Q_total << "/" << Q_total << " = "
+            << std::setprecision(4) << fs.traffic << "\n\n";
 
         oss << "• Traffic Delay Score = ";
-        for (const auto& L : lignes) {
-            int d = std::max(0, L.t - L.t_start);
-            oss << L.q << "/" << Q_total
-                << "*1/" << d << "+10 ";
+        for (const Ligne* L : lignes) {
+            int d = std::max(0, L->t - flow.startTime);
+            oss << std::setprecision(1) << L->q << "/" << Q_total
+                << "*10/(" << d << "+10) ";
         }
         oss << "= " << std::fixed << std::setprecision(4)
-            << TrafficDelayScore << "\n\n";
+            << fs.delay << "\n\n";
 
         oss << "• Transmission Distance Score = ";
-        oss << std::fixed << std::setprecision(4) << DistScore << "\n\n";
+        oss << std::fixed << std::setprecision(4) << fs.distance << "\n\n";
 
-        oss << "• U2G Point Score: k=" << k
-            << " => " << std::fixed << std::setprecision(1)
+        oss << "• U2G Point Score: k=" << fs.k
+            << " => " << std::fixed << std::setprecision(4)
             << U2GPointScore << "\n\n";
 
-        oss << "• Total Score = 100(0.4*" << U2G_Score
-            << " + 0.2*" << TrafficDelayScore
-            << " + 0.3*" << DistScore
+        oss << "• Total Score = 100(0.4*" << fs.traffic
+            << " + 0.2*" << fs.delay
+            << " + 0.3*" << fs.distance
             << " + 0.1*" << U2GPointScore
             << ") = " << std::fixed << std::setprecision(3)
-            << totalScore << "\n";
-
-        totalWeighted += Q_total * totalScore;
+            << fs.total << "\n";
     }
 
-    if (totalSize > 0.0) {
-        double overall = totalWeighted / totalSize;
-        oss << "\nTotal score: "
-            << std::fixed << std::setprecision(3)
-            << overall << "\n";
-    }
+    oss << "\nTotal score: "
+        << std::fixed << std::setprecision(3)
+        << report.total << "\n";
 
     return oss.str();
 }
@@ -1,4 +1,8 @@
 #include "CubeOptimizer.h"
+#include "Deadline.h"
+#include "ThreadPool.h"
+#include "Log.h"
+#include "Metrics.h"
 #include <iomanip>
 #include <algorithm>
 #include <cmath>
@@ -6,9 +10,7 @@
 #include <set>
 #include <sstream>
 
-// ====== 调试开关 ======
-static constexpr bool OPT_DEBUG  = true;   // 逻辑级 Debug
-static constexpr bool OPT_VISUAL = true;   // 可视化网格
+// 日志：迭代过程为 Debug，逐格明细与整表/网格可视化为 Trace（见 Log.h）
 
 // 为了对齐输出
 static inline std::string fmt2(double v, int w=6, int p=2) {
@@ -17,8 +19,10 @@ static inline std::string fmt2(double v, int w=6, int p=2) {
     return oss.str();
 }
 
-CubeOptimizer::CubeOptimizer(const Network& net, const Cube& inputCube)
-    : network_(net), cube_(inputCube) {
+CubeOptimizer::CubeOptimizer(const Network& net, const Cube& inputCube, ThreadPool* pool,
+                             const Deadline* deadline, size_t nodeBudget)
+    : network_(net), cube_(inputCube), pool_(pool), evaluator_(net), deadline_(deadline),
+      nodeBudget_(nodeBudget) {
     // 保障 cube_ 含有 0..T-1 的切片槽位，避免后续 t_high/t_low 超界
     if ((int)cube_.slices.size() < network_.T) {
         cube_.slices.resize(network_.T);
@@ -27,88 +31,87 @@ CubeOptimizer::CubeOptimizer(const Network& net, const Cube& inputCube)
         cube_.slices[t].t = t;
     }
 
+    // P 表与脏标记；初始全部为脏，首次 buildPotentialTable() 全量计算
+    const int FN = static_cast<int>(network_.flows.size());
+    potentialTable_.reset(FN, std::max(0, network_.T));
+    potentialDirty_.assign(potentialTable_.cells.size(), 1);
+    flowDirty_.assign(FN, 1);
+    flowVersion_.assign(FN, 0);
+
     // 构建初始 C 表，用作效率排序的基线
     buildConfirmedTable();
     baselineConfirmedTable_ = confirmedTable_;
 }
 
 static inline double getFlowTotalSize(const Network& net, int fid) {
-    for (const auto& f : net.flows) if (f.id == fid) return f.size;
-    return 0.0;
+    const Flow* f = net.flowById(fid);
+    return f ? f->size : 0.0;
 }
 
 /* ------------------- 可视化工具 ------------------- */
 void CubeOptimizer::visualPrintCube(const std::string& title) const {
-    if (!OPT_VISUAL) return;
-    std::cout << "\n==== [Cube Visual] " << title << " ====\n";
+    if (!UAV_LOG_ON(CubeOptimizer, Trace)) return;
+    Log::Line line(LogLevel::Trace);
+    line << "\n==== [Cube Visual] " << title << " ====\n";
     for (int t = 0; t < (int)cube_.slices.size(); ++t) {
         const auto& s = cube_.slices[t];
-        std::cout << "t=" << t << " | ";
+        line << "t=" << t << " | ";
         std::map<int,double> flowQ;
         for (const auto& L : s.lignes) flowQ[L.flowId] += L.q;
         for (const auto& f : network_.flows) {
             double q = flowQ.count(f.id) ? flowQ.at(f.id) : 0.0;
-            std::cout << "F" << f.id << ":" << fmt2(q) << "  ";
+            line << "F" << f.id << ":" << fmt2(q) << "  ";
         }
-        std::cout << "\n";
+        line << "\n";
     }
 }
 
 void CubeOptimizer::visualPrintTableC() const {
-    if (!OPT_VISUAL) return;
-    std::cout << "\n---- [C-table Visual] 确定表 (q/eff) ----\n";
+    if (!UAV_LOG_ON(CubeOptimizer, Trace)) return;
+    Log::Line line(LogLevel::Trace);
+    line << "\n---- [C-table Visual] 确定表 (q/eff) ----\n";
     // 打印列头
-    std::cout << "      ";
-    for (int t = 0; t < network_.T; ++t) std::cout << "  t" << std::setw(2) << t << "      ";
-    std::cout << "\n";
-    for (const auto& f : network_.flows) {
-        int fid = f.id;
-        std::cout << "F" << fid << " | ";
+    line << "      ";
+    for (int t = 0; t < network_.T; ++t) line << "  t" << std::setw(2) << t << "      ";
+    line << "\n";
+    for (int fi = 0; fi < (int)network_.flows.size(); ++fi) {
+        line << "F" << network_.flows[fi].id << " | ";
         for (int t = 0; t < network_.T; ++t) {
-            auto itR = confirmedTable_.find(fid);
-            double q=0, eff=0;
-            if (itR != confirmedTable_.end()) {
-                auto it = itR->second.find(t);
-                if (it != itR->second.end() && it->second.valid) {
-                    q = it->second.q; eff = it->second.eff;
-                }
-            }
-            std::cout << fmt2(q) << "/" << fmt2(eff,5,3) << "  ";
+            const auto& cell = confirmedTable_.at(fi, t);
+            double q = cell.valid ? cell.q : 0.0;
+            double eff = cell.valid ? cell.eff : 0.0;
+            line << fmt2(q) << "/" << fmt2(eff,5,3) << "  ";
         }
-        std::cout << "\n";
+        line << "\n";
     }
 }
 
 void CubeOptimizer::visualPrintTableP() const {
-    if (!OPT_VISUAL) return;
-    std::cout << "\n---- [P-table Visual] 潜力表 (q/eff) ----\n";
-    std::cout << "      ";
-    for (int t = 0; t < network_.T; ++t) std::cout << "  t" << std::setw(2) << t << "      ";
-    std::cout << "\n";
-    for (const auto& f : network_.flows) {
-        int fid = f.id;
-        std::cout << "F" << fid << " | ";
+    if (!UAV_LOG_ON(CubeOptimizer, Trace)) return;
+    Log::Line line(LogLevel::Trace);
+    line << "\n---- [P-table Visual] 潜力表 (q/eff) ----\n";
+    line << "      ";
+    for (int t = 0; t < network_.T; ++t) line << "  t" << std::setw(2) << t << "      ";
+    line << "\n";
+    for (int fi = 0; fi < (int)network_.flows.size(); ++fi) {
+        line << "F" << network_.flows[fi].id << " | ";
         for (int t = 0; t < network_.T; ++t) {
-            double q=0, eff=0;
-            auto itR = potentialTable_.find(fid);
-            if (itR != potentialTable_.end()) {
-                auto it = itR->second.find(t);
-                if (it != itR->second.end() && it->second.valid) {
-                    q = it->second.q; eff = it->second.eff;
-                }
-            }
-            std::cout << fmt2(q) << "/" << fmt2(eff,5,3) << "  ";
+            const auto& cell = potentialTable_.at(fi, t);
+            double q = cell.valid ? cell.q : 0.0;
+            double eff = cell.valid ? cell.eff : 0.0;
+            line << fmt2(q) << "/" << fmt2(eff,5,3) << "  ";
         }
-        std::cout << "\n";
+        line << "\n";
     }
 }
 
 /* ------------------- 主流程 ------------------- */
 Cube CubeOptimizer::optimize() {
-    if (OPT_DEBUG) std::cout << "\n=== ⚙️ CubeOptimizer 启动 ===\n";
+    UAV_LOG(CubeOptimizer, Debug) << "\n=== ⚙️ CubeOptimizer 启动 ===\n";
 
     buildConfirmedTable();
-    if (OPT_DEBUG) logTableSummary("Initial Confirmed Table", confirmedTable_);
+    logTableSummary("Initial Confirmed Table", confirmedTable_);
+    UAV_LOG(CubeOptimizer, Debug) << "官方评分: " << evaluator_.score(cube_) << "\n";
     visualPrintCube("Initial Cube");
     visualPrintTableC();
 
@@ -116,74 +119,84 @@ Cube CubeOptimizer::optimize() {
     while (true) {
         ++iter;
         if (iter > 50) {
-            std::cout << "⚠️ 达到最大迭代次数，强制结束优化。\n";
+            UAV_LOG(CubeOptimizer, Warn) << "⚠️ 达到最大迭代次数，强制结束优化。\n";
+            break;
+        }
+        if (expired(deadline_)) {
+            UAV_LOG(CubeOptimizer, Info) << "⏱ 时间预算用尽，停止优化（已完成 " << iter - 1 << " 轮）。\n";
             break;
         }
 
-        if (OPT_DEBUG) std::cout << "\n--- 🌀 优化迭代 #" << iter << " ---\n";
+        Metrics::add(MetricCounter::OptimizerIterations);
+        UAV_LOG(CubeOptimizer, Debug) << "\n--- 🌀 优化迭代 #" << iter << " ---\n";
 
         buildPotentialTable();
-        if (OPT_DEBUG) logTableSummary("Potential Table", potentialTable_);
+        logTableSummary("Potential Table", potentialTable_);
         visualPrintTableP();
 
         auto [fid, t_high, gap, hasCapacity] = findMaxEfficiencyGap();
         (void)hasCapacity;
         if (fid == -1 || gap < 1e-6) {
-            if (OPT_DEBUG) std::cout << "\n✅ 潜力效率不再高于当前效率，优化结束。\n";
+            UAV_LOG(CubeOptimizer, Debug) << "\n✅ 潜力效率不再高于当前效率，优化结束。\n";
             break;
         }
 
         // 找 C 表中最低效率时刻（有流量）
         int t_low = -1;
         double eff_min = 1e18;
-        auto itRow = confirmedTable_.find(fid);
-        if (itRow != confirmedTable_.end()) {
-            for (const auto& [t, cell] : itRow->second) {
-                if (cell.valid && cell.q > 1e-9 && cell.eff < eff_min) {
-                    eff_min = cell.eff;
-                    t_low = t;
-                }
+        const int fi = network_.flowIndex(fid);
+        for (int t = 0; t < network_.T; ++t) {
+            const auto& cell = confirmedTable_.at(fi, t);
+            if (cell.valid && cell.q > 1e-9 && cell.eff < eff_min) {
+                eff_min = cell.eff;
+                t_low = t;
             }
         }
         if (t_low == -1) {
-            if (OPT_DEBUG) std::cout << "⚠️ Flow#" << fid << " 无可释放的低效时刻，跳过。\n";
+            UAV_LOG(CubeOptimizer, Debug) << "⚠️ Flow#" << fid << " 无可释放的低效时刻，跳过。\n";
             break;
         }
 
-        if (OPT_DEBUG) {
-            std::cout << "🔍 发现改进：Flow#" << fid
-                      << " t_high=" << t_high << " (潜力高)  t_low=" << t_low << " (当前低)"
-                      << " gap=" << gap << "\n";
-        }
+        UAV_LOG(CubeOptimizer, Debug) << "🔍 发现改进：Flow#" << fid
+                                      << " t_high=" << t_high << " (潜力高)  t_low=" << t_low << " (当前低)"
+                                      << " gap=" << gap << "\n";
 
         // 前后可视化
         visualPrintCube("Before Rebalance");
         visualPrintTableC();
 
         rebalanceFlow(fid, t_high, t_low);
+        Metrics::add(MetricCounter::OptimizerMoves);
 
         // 重新构建确定表和潜力表
         buildConfirmedTable();
+        UAV_LOG(CubeOptimizer, Debug) << "官方评分: " << evaluator_.score(cube_) << "\n";
         visualPrintCube("After Rebalance");
         visualPrintTableC();
 
         buildPotentialTable();
-        if (OPT_DEBUG) logTableSummary("Potential Table (post-rebalance)", potentialTable_);
+        logTableSummary("Potential Table (post-rebalance)", potentialTable_);
         visualPrintTableP();
     }
 
-    if (OPT_DEBUG) std::cout << "\n=== ✅ CubeOptimizer 完成 ===\n";
+    UAV_LOG(CubeOptimizer, Debug) << "\n=== ✅ CubeOptimizer 完成 ===\n";
     return cube_;
 }
 
 /* ------------------- 构建确定表 ------------------- */
 void CubeOptimizer::buildConfirmedTable() {
-    confirmedTable_.clear();
+    const int FN = static_cast<int>(network_.flows.size());
+    Table previous = std::move(confirmedTable_);
+    std::vector<int> previousChanges = std::move(landingChanges_);
+    confirmedTable_.reset(FN, network_.T);
 
     for (const auto& slice : cube_.slices) {
         int t = slice.t;
+        if (t < 0 || t >= network_.T) continue;
         for (const auto& L : slice.lignes) {
-            auto& cell = confirmedTable_[L.flowId][t];
+            const int fi = network_.flowIndex(L.flowId);
+            if (fi < 0) continue;
+            auto& cell = confirmedTable_.at(fi, t);
             cell.q     = L.q;
             cell.score = L.score;
             cell.eff   = (L.q > 1e-9 ? L.score / L.q : 0.0);
@@ -192,69 +205,126 @@ void CubeOptimizer::buildConfirmedTable() {
                                           : L.pathXY.back();
         }
     }
+
+    landingChanges_.resize(FN);
+    for (int fi = 0; fi < FN; ++fi)
+        landingChanges_[fi] = landingChangeCount(confirmedTable_, fi);
+
+    markConfirmedChangesDirty(previous, previousChanges);
+}
+
+/* ------------------- 脏标记 ------------------- */
+void CubeOptimizer::markPotentialDirty(int fi, int t) {
+    if (fi < 0 || t < 0 || t >= network_.T) return;
+    potentialDirty_[static_cast<size_t>(fi) * network_.T + t] = 1;
+}
+
+void CubeOptimizer::markSliceDirty(int t) {
+    // 切片 t 变化 → 所有流在 t 的扣减带宽都变了
+    for (int fi = 0; fi < (int)network_.flows.size(); ++fi)
+        markPotentialDirty(fi, t);
+}
+
+void CubeOptimizer::markConfirmedChangesDirty(const Table& previous,
+                                              const std::vector<int>& previousChanges) {
+    const int FN = static_cast<int>(network_.flows.size());
+    const int T  = network_.T;
+    if (previous.cells.size() != confirmedTable_.cells.size() ||
+        (int)previousChanges.size() != FN) {
+        // 首次构建：全部失效
+        std::fill(potentialDirty_.begin(), potentialDirty_.end(), 1);
+        std::fill(flowDirty_.begin(), flowDirty_.end(), 1);
+        return;
+    }
+
+    // P 格只通过 (valid, endXY, q>0) 读取邻格，见 getLast/NextLanding、getNeighborState
+    auto landingKey = [](const CellData& c) {
+        if (!c.valid) return std::make_tuple(false, std::make_pair(-1,-1), false);
+        return std::make_tuple(true, c.endXY, c.q > 1e-9);
+    };
+
+    for (int fi = 0; fi < FN; ++fi) {
+        // 落点变化次数是整行的全局量，变化时整行失效
+        const bool wholeRow = previousChanges[fi] != landingChanges_[fi];
+        bool rowChanged = wholeRow;
+        for (int t = 0; t < T; ++t) {
+            const auto& before = previous.at(fi, t);
+            const auto& after  = confirmedTable_.at(fi, t);
+            if (wholeRow) markPotentialDirty(fi, t);
+            if (landingKey(before) != landingKey(after)) {
+                markPotentialDirty(fi, t - 1);
+                markPotentialDirty(fi, t + 1);
+                rowChanged = true;
+            } else if (before.q != after.q || before.eff != after.eff) {
+                rowChanged = true;
+            }
+        }
+        if (rowChanged) flowDirty_[fi] = 1;
+    }
 }
 
 /* ------------------- 构建潜力表 ------------------- */
 void CubeOptimizer::buildPotentialTable() {
-    potentialTable_.clear();
     constexpr double EPS = CubeOptimizer::EPS;
 
-    for (const auto& flow : network_.flows) {
-        int fid = flow.id;
-        const double totalQ = getFlowTotalSize(network_, fid);
-        if (totalQ <= EPS) continue;
-
-        for (int t = 0; t < network_.T; ++t) {
-            auto bw = makeMaskedBwForPotential(fid, t);
-            auto lastXY = getLastLanding(fid, t);
-            auto nextXY = getNextLanding(fid, t);
-            int  kCount = getLandingChangeCountGlobal(fid);
-            int  nState = getNeighborState(fid, t);
-            double rem = totalQ;  // 潜力表用总量（你指定的规则）
-
-            LigneFinder finder(network_, flow, t, bw,
-                               lastXY, nextXY,
-                               kCount, nState,
-                               rem);
-
-            auto lignes = finder.runAStarOnce();
-            if (lignes.empty()) continue;
-
-            const Ligne* best = nullptr;
-            double bestEff = -1e18;
-            for (const auto& L : lignes) {
-                if (L.q <= EPS) continue;
-                double eff = L.score / L.q;
-                if (eff > bestEff) {
-                    bestEff = eff;
-                    best = &L;
+    // 只重算脏格。各 (flow,t) 格只读 cube_ / confirmedTable_，彼此独立：
+    // 每 kPotentialTile 个脏格为一个并行任务，结果直接写回稠密 P 表
+    const int FN = static_cast<int>(network_.flows.size());
+    const int T  = network_.T;
+    if (FN <= 0 || T <= 0) return;
+
+    std::vector<int> dirty;
+    for (int idx = 0; idx < FN * T; ++idx)
+        if (potentialDirty_[idx]) dirty.push_back(idx);
+    std::vector<char> changed(dirty.size(), 0);
+
+    auto fillTile = [&](int tile) {
+        const int begin = tile * kPotentialTile;
+        const int end   = std::min<int>(dirty.size(), begin + kPotentialTile);
+        for (int k = begin; k < end; ++k) {
+            const int idx = dirty[k];
+            const Flow& flow = network_.flows[idx / T];
+            const int t = idx % T;
+
+            CellData cell;
+            if (getFlowTotalSize(network_, flow.id) > EPS) {
+                if (auto best = computeBestPotentialLigne(flow.id, t)) {
+                    cell.q     = best->q;
+                    cell.score = best->score;
+                    cell.eff   = best->score / best->q;
+                    cell.valid = true;
+                    cell.endXY = best->pathXY.empty() ? std::make_pair(-1,-1)
+                                                      : best->pathXY.back();
                 }
             }
-            if (!best) continue;
-
-            double qC = 0.0;
-            auto itRowC = confirmedTable_.find(fid);
-            if (itRowC != confirmedTable_.end()) {
-                auto itC = itRowC->second.find(t);
-                if (itC != itRowC->second.end() && itC->second.valid)
-                    qC = itC->second.q;
-            }
 
-            auto& cell = potentialTable_[fid][t];
-            cell.q     = best->q;
-            cell.score = best->score;
-            cell.eff   = bestEff;
-            cell.valid = true;
-            cell.endXY = best->pathXY.empty() ? std::make_pair(-1,-1)
-                                              : best->pathXY.back();
-
-            if (OPT_DEBUG) {
-                std::cout << "[P-add] Flow#" << fid
-                          << " t=" << t
-                          << " q=" << cell.q
-                          << " score=" << cell.score
-                          << " eff=" << cell.eff << "\n";
-            }
+            auto& slot = potentialTable_.cells[idx];
+            changed[k] = slot.valid != cell.valid || slot.q != cell.q || slot.eff != cell.eff;
+            slot = cell;
+        }
+    };
+
+    const int tiles = (static_cast<int>(dirty.size()) + kPotentialTile - 1) / kPotentialTile;
+    if (pool_ && pool_->size() > 1 && tiles > 1)
+        pool_->parallelFor(tiles, fillTile);
+    else
+        for (int i = 0; i < tiles; ++i) fillTile(i);
+
+    for (size_t k = 0; k < dirty.size(); ++k)
+        if (changed[k]) flowDirty_[dirty[k] / T] = 1;
+    std::fill(potentialDirty_.begin(), potentialDirty_.end(), 0);
+
+    UAV_LOG(CubeOptimizer, Debug) << "[P-table] 重算 " << dirty.size() << "/" << FN * T << " 格\n";
+    if (UAV_LOG_ON(CubeOptimizer, Trace)) {
+        Log::Line line(LogLevel::Trace);
+        for (int idx : dirty) {
+            const auto& cell = potentialTable_.cells[idx];
+            if (!cell.valid) continue;
+            line << "[P-add] Flow#" << network_.flows[idx / T].id
+                 << " t=" << idx % T
+                 << " q=" << cell.q
+                 << " score=" << cell.score
+                 << " eff=" << cell.eff << "\n";
         }
     }
 }
@@ -262,31 +332,32 @@ void CubeOptimizer::buildPotentialTable() {
 /* ------------------- 邻接状态/上下文 ------------------- */
 std::pair<int,int> CubeOptimizer::getLastLanding(int fid, int t) const {
     if (t <= 0) return {-1,-1};
-    auto itRow = confirmedTable_.find(fid);
-    if (itRow == confirmedTable_.end()) return {-1,-1};
-    auto it = itRow->second.find(t-1);
-    if (it == itRow->second.end()) return {-1,-1};
-    return it->second.valid ? it->second.endXY : std::make_pair(-1,-1);
+    const int fi = network_.flowIndex(fid);
+    if (fi < 0) return {-1,-1};
+    const auto& cell = confirmedTable_.at(fi, t-1);
+    return cell.valid ? cell.endXY : std::make_pair(-1,-1);
 }
 
 std::pair<int,int> CubeOptimizer::getNextLanding(int fid, int t) const {
     if (t >= network_.T-1) return {-1,-1};
-    auto itRow = confirmedTable_.find(fid);
-    if (itRow == confirmedTable_.end()) return {-1,-1};
-    auto it = itRow->second.find(t+1);
-    if (it == itRow->second.end()) return {-1,-1};
-    return it->second.valid ? it->second.endXY : std::make_pair(-1,-1);
+    const int fi = network_.flowIndex(fid);
+    if (fi < 0) return {-1,-1};
+    const auto& cell = confirmedTable_.at(fi, t+1);
+    return cell.valid ? cell.endXY : std::make_pair(-1,-1);
 }
 
 int CubeOptimizer::getLandingChangeCountGlobal(int fid) const {
-    auto itRow = confirmedTable_.find(fid);
-    if (itRow == confirmedTable_.end()) return 0;
+    const int fi = network_.flowIndex(fid);
+    return fi < 0 ? 0 : landingChanges_[fi];
+}
 
+int CubeOptimizer::landingChangeCount(const Table& tbl, int fi) const {
     int k = 0;
     std::pair<int,int> prev{-1,-1};
     bool hasPrev = false;
 
-    for (const auto& [t, cell] : itRow->second) {
+    for (int t = 0; t < tbl.T; ++t) {
+        const auto& cell = tbl.at(fi, t);
         if (!cell.valid || cell.q <= 1e-9) continue;
         if (!hasPrev) {
             prev = cell.endXY;
@@ -304,37 +375,28 @@ int CubeOptimizer::getLandingChangeCountGlobal(int fid) const {
 int CubeOptimizer::getNeighborState(int fid, int t) const {
     bool leftEdge  = (t == 0);
     bool rightEdge = (t == network_.T - 1);
-    auto itRow = confirmedTable_.find(fid);
-    bool hasL = false, hasR = false;
-    if (!leftEdge && itRow != confirmedTable_.end()) {
-        auto itL = itRow->second.find(t-1);
-        hasL = (itL != itRow->second.end() && itL->second.valid && itL->second.q > 1e-9);
-    }
-    if (!rightEdge && itRow != confirmedTable_.end()) {
-        auto itR = itRow->second.find(t+1);
-        hasR = (itR != itRow->second.end() && itR->second.valid && itR->second.q > 1e-9);
-    }
+    const int fi = network_.flowIndex(fid);
+    auto hasTraffic = [&](int tt) {
+        const auto& cell = confirmedTable_.at(fi, tt);
+        return cell.valid && cell.q > 1e-9;
+    };
+    bool hasL = !leftEdge  && fi >= 0 && hasTraffic(t-1);
+    bool hasR = !rightEdge && fi >= 0 && hasTraffic(t+1);
     if ((hasL || leftEdge) && (hasR || rightEdge)) return 0;
     if ((hasL || leftEdge) ^ (hasR || rightEdge)) return 1;
     return 2;
 }
 
 /* ------------------- 扣减其它流占用 ------------------- */
-std::map<std::pair<int,int>, double>
-CubeOptimizer::makeMaskedBwForPotential(int fid, int t) const {
-    std::map<std::pair<int,int>, double> bw;
-    for (const auto& u : network_.uavs)
-        bw[{u.x, u.y}] = u.bandwidthAt(t);
+BandwidthGrid CubeOptimizer::makeMaskedBwForPotential(int fid, int t) const {
+    BandwidthGrid bw = network_.bandwidthAt(t);
 
     // ✅ 只扣除其它流
     if (t >= 0 && t < (int)cube_.slices.size()) {
         const auto& slice = cube_.slices[t];
         for (const auto& L : slice.lignes) {
             if (L.flowId == fid) continue; // 不扣本流
-            for (const auto& xy : L.pathXY) {
-                auto& b = bw[xy];
-                b = std::max(0.0, b - L.q);
-            }
+            bw.subtractPath(L.pathXY, L.q);
         }
     }
     return bw;
@@ -342,28 +404,31 @@ CubeOptimizer::makeMaskedBwForPotential(int fid, int t) const {
 
 
 /* ------------------- 寻找最大 gap ------------------- */
-std::tuple<int,int,double,bool> CubeOptimizer::findMaxEfficiencyGap() const {
+void CubeOptimizer::refreshGapCandidates() {
     constexpr double EPS = CubeOptimizer::EPS;
-    int bestF = -1, bestT = -1;
-    double bestGap = 0.0;
-    bool bestHasCapacity = false;
-
-    for (const auto& flow : network_.flows) {
-        int fid = flow.id;
+    const int FN = static_cast<int>(network_.flows.size());
+    const int T  = network_.T;
+
+    // 懒删除使堆中堆积过期条目；超过上限时整体重建
+    if (capacityHeap_.size() + replaceHeap_.size() > 4 * potentialTable_.cells.size() + 64) {
+        capacityHeap_ = GapHeap();
+        replaceHeap_  = GapHeap();
+        std::fill(flowDirty_.begin(), flowDirty_.end(), 1);
+    }
 
-        auto itCurrent = confirmedTable_.find(fid);
-        if (itCurrent == confirmedTable_.end()) continue;
-        auto itBase = baselineConfirmedTable_.find(fid);
-        if (itBase == baselineConfirmedTable_.end()) continue;
+    for (int fi = 0; fi < FN; ++fi) {
+        if (!flowDirty_[fi]) continue;
+        flowDirty_[fi] = 0;
+        const unsigned version = ++flowVersion_[fi];   // 该流的旧候选全部过期
 
+        // 基线中效率最低、且当前仍有流量的时刻
         double effMinBase = 1e18;
         int tLow = -1;
-        for (const auto& [t, baseCell] : itBase->second) {
+        for (int t = 0; t < T; ++t) {
+            const auto& baseCell = baselineConfirmedTable_.at(fi, t);
             if (!baseCell.valid || baseCell.q <= EPS) continue;
-            double qNow = 0.0;
-            if (auto itCur = itCurrent->second.find(t);
-                itCur != itCurrent->second.end() && itCur->second.valid)
-                qNow = itCur->second.q;
+            const auto& cur = confirmedTable_.at(fi, t);
+            double qNow = cur.valid ? cur.q : 0.0;
             if (qNow <= EPS) continue; // 当前已经没有该时刻的流量
             if (baseCell.eff < effMinBase) {
                 effMinBase = baseCell.eff;
@@ -372,52 +437,47 @@ std::tuple<int,int,double,bool> CubeOptimizer::findMaxEfficiencyGap() const {
         }
         if (tLow == -1) continue;
 
-        auto itP = potentialTable_.find(fid);
-        if (itP == potentialTable_.end()) continue;
-
-        for (const auto& [t, pcell] : itP->second) {
+        for (int t = 0; t < T; ++t) {
+            const auto& pcell = potentialTable_.at(fi, t);
             if (!pcell.valid) continue;
 
-            double qCurrent = 0.0;
-            if (auto itCell = itCurrent->second.find(t);
-                itCell != itCurrent->second.end() && itCell->second.valid)
-                qCurrent = itCell->second.q;
+            const auto& cur = confirmedTable_.at(fi, t);
+            double qCurrent = cur.valid ? cur.q : 0.0;
 
             double capacityGain = pcell.q - qCurrent;
             double gap = pcell.eff - effMinBase;
-            if (capacityGain > EPS) {
-                if (gap > bestGap + 1e-9 ||
-                    (gap > bestGap - 1e-9 && !bestHasCapacity)) {
-                    bestGap = gap;
-                    bestF = fid;
-                    bestT = t;
-                    bestHasCapacity = true;
-                }
-            } else if (t == tLow && qCurrent > EPS && gap > 1e-6 && !bestHasCapacity) {
-                // 仅当当前没有“可扩容”候选时，才考虑同一时刻的纯替换
-                if (gap > bestGap + 1e-9) {
-                    bestGap = gap;
-                    bestF = fid;
-                    bestT = t;
-                    bestHasCapacity = false;
-                }
-            }
+            if (gap <= 1e-6) continue;
+            if (capacityGain > EPS)
+                capacityHeap_.push({gap, fi, t, version});
+            else if (t == tLow && qCurrent > EPS)
+                replaceHeap_.push({gap, fi, t, version});
         }
     }
+}
 
-    if (bestF == -1 || bestGap <= 1e-6)
-        return {-1, -1, 0.0, false};
+const CubeOptimizer::GapCandidate* CubeOptimizer::liveTop(GapHeap& heap) const {
+    while (!heap.empty() && heap.top().version != flowVersion_[heap.top().fi])
+        heap.pop();
+    return heap.empty() ? nullptr : &heap.top();
+}
+
+std::tuple<int,int,double,bool> CubeOptimizer::findMaxEfficiencyGap() {
+    refreshGapCandidates();
 
-    return {bestF, bestT, bestGap, bestHasCapacity};
+    // 可扩容候选优先；没有可扩容候选时，才考虑同一时刻的纯替换
+    if (const auto* c = liveTop(capacityHeap_))
+        return {network_.flows[c->fi].id, c->t, c->gap, true};
+    if (const auto* c = liveTop(replaceHeap_))
+        return {network_.flows[c->fi].id, c->t, c->gap, false};
+    return {-1, -1, 0.0, false};
 }
 
 /* ------------------- 重分配（含兜底替换） ------------------- */
 void CubeOptimizer::rebalanceFlow(int fid, int t_high, int t_low) {
     constexpr double EPS = CubeOptimizer::EPS;
 
-    if (OPT_DEBUG)
-        std::cout << "  ⚙️ Rebalancing Flow#" << fid
-                  << " between t_low=" << t_low << " and t_high=" << t_high << "\n";
+    UAV_LOG(CubeOptimizer, Debug) << "  ⚙️ Rebalancing Flow#" << fid
+                                  << " between t_low=" << t_low << " and t_high=" << t_high << "\n";
 
     // Step 1: 计算 Δq
     double q_low = 0.0;
@@ -426,19 +486,12 @@ void CubeOptimizer::rebalanceFlow(int fid, int t_high, int t_low) {
     double q_high_potential = 0.0;
     double eff_high_potential = 0.0;
 
-    if (auto itC = confirmedTable_.find(fid); itC != confirmedTable_.end()) {
-        if (auto it = itC->second.find(t_low); it != itC->second.end())
-            q_low = it->second.q;
-        if (auto it2= itC->second.find(t_high); it2!= itC->second.end()) {
-            q_high_current = it2->second.q;
-            eff_high_current = it2->second.eff;
-        }
-    }
-    if (auto itP = potentialTable_.find(fid); itP != potentialTable_.end()) {
-        if (auto it = itP->second.find(t_high); it != itP->second.end()) {
-            q_high_potential = it->second.q;
-            eff_high_potential = it->second.eff;
-        }
+    if (const int fi = network_.flowIndex(fid); fi >= 0) {
+        q_low            = confirmedTable_.at(fi, t_low).q;
+        q_high_current   = confirmedTable_.at(fi, t_high).q;
+        eff_high_current = confirmedTable_.at(fi, t_high).eff;
+        q_high_potential   = potentialTable_.at(fi, t_high).q;
+        eff_high_potential = potentialTable_.at(fi, t_high).eff;
     }
 
     double capacityGain = std::max(0.0, q_high_potential - q_high_current);
@@ -446,38 +499,33 @@ void CubeOptimizer::rebalanceFlow(int fid, int t_high, int t_low) {
     if (deltaQ <= EPS) {
         if (t_low == t_high && q_high_current > EPS &&
             eff_high_potential > eff_high_current + 1e-6) {
-            if (OPT_DEBUG) {
-                std::cout << "  🔁 Δq≈0，但尝试在 t=" << t_high
-                          << " 内直接替换为潜力最优路径 (q=" << q_high_current << ")\n";
-            }
+            UAV_LOG(CubeOptimizer, Debug) << "  🔁 Δq≈0，但尝试在 t=" << t_high
+                                          << " 内直接替换为潜力最优路径 (q=" << q_high_current << ")\n";
             if (applyDirectReplacement(fid, t_high, q_high_current)) {
                 buildConfirmedTable();
-                if (OPT_DEBUG) {
-                    std::cout << "  ✅ Flow#" << fid << " 在 t=" << t_high
-                              << " 已替换为潜力路径（保持同等流量）。\n";
-                }
-            } else if (OPT_DEBUG) {
-                std::cout << "  ⚠️ 直接替换失败：潜力路径不足以覆盖当前流量。\n";
+                UAV_LOG(CubeOptimizer, Debug) << "  ✅ Flow#" << fid << " 在 t=" << t_high
+                                              << " 已替换为潜力路径（保持同等流量）。\n";
+            } else {
+                UAV_LOG(CubeOptimizer, Debug) << "  ⚠️ 直接替换失败：潜力路径不足以覆盖当前流量。\n";
             }
-        } else if (OPT_DEBUG) {
-            std::cout << "  ⚠️ Δq≈0，跳过本次重排。\n";
+        } else {
+            UAV_LOG(CubeOptimizer, Debug) << "  ⚠️ Δq≈0，跳过本次重排。\n";
         }
         return;
     }
 
     double targetHighQ = q_high_current + deltaQ;
 
-    if (OPT_DEBUG) {
-        std::cout << "  → Δq=" << deltaQ
-                  << " (t_low=" << t_low << " q_low=" << q_low
-                  << " → t_high=" << t_high << " q_high_now=" << q_high_current
-                  << " q_high_pot=" << q_high_potential
-                  << " targetHighQ=" << targetHighQ << ")\n";
-    }
+    UAV_LOG(CubeOptimizer, Debug) << "  → Δq=" << deltaQ
+                                  << " (t_low=" << t_low << " q_low=" << q_low
+                                  << " → t_high=" << t_high << " q_high_now=" << q_high_current
+                                  << " q_high_pot=" << q_high_potential
+                                  << " targetHighQ=" << targetHighQ << ")\n";
 
     auto reduceFlowOnSlice = [&](int t, double amount) {
         if (t < 0 || t >= (int)cube_.slices.size()) return;
         auto& sl = cube_.slices[t];
+        markSliceDirty(t);
         double need = amount;
         for (auto it = sl.lignes.begin(); it != sl.lignes.end() && need > EPS; ) {
             if (it->flowId != fid) { ++it; continue; }
@@ -492,8 +540,8 @@ void CubeOptimizer::rebalanceFlow(int fid, int t_high, int t_low) {
             if (it->q <= EPS) it = sl.lignes.erase(it);
             else ++it;
         }
-        if (need > EPS && OPT_DEBUG) {
-            std::cout << "  ⚠️ t=" << t << " 未能完全释放 Δq，剩余=" << need << "\n";
+        if (need > EPS) {
+            UAV_LOG(CubeOptimizer, Debug) << "  ⚠️ t=" << t << " 未能完全释放 Δq，剩余=" << need << "\n";
         }
     };
 
@@ -516,6 +564,7 @@ void CubeOptimizer::rebalanceFlow(int fid, int t_high, int t_low) {
         }
 
         auto& slHigh = cube_.slices[t_high];
+        markSliceDirty(t_high);
         slHigh.lignes.erase(std::remove_if(slHigh.lignes.begin(), slHigh.lignes.end(),
                                            [&](const Ligne& L){ return L.flowId == fid; }),
                             slHigh.lignes.end());
@@ -527,43 +576,45 @@ void CubeOptimizer::rebalanceFlow(int fid, int t_high, int t_low) {
             if (L.flowId == fid) qChk += L.q;
         increased = (qChk >= targetHighQ - 1e-6);
 
-        if (OPT_DEBUG) {
-            std::cout << "  ✅ t_high=" << t_high << " 用潜力路径重建 fid="
-                      << fid << " q=" << qChk
-                      << " (target=" << targetHighQ << ")\n";
-        }
-    } else if (OPT_DEBUG) {
-        std::cout << "  ⚠️ 未找到 t_high=" << t_high << " 的潜力路径，无法扩充。\n";
+        UAV_LOG(CubeOptimizer, Debug) << "  ✅ t_high=" << t_high << " 用潜力路径重建 fid="
+                                      << fid << " q=" << qChk
+                                      << " (target=" << targetHighQ << ")\n";
+    } else {
+        UAV_LOG(CubeOptimizer, Debug) << "  ⚠️ 未找到 t_high=" << t_high << " 的潜力路径，无法扩充。\n";
     }
 
     // Step 5: 更新确定表（供下一轮判断）
     buildConfirmedTable();
 
-    if (OPT_DEBUG)
-        std::cout << "  ✅ Flow#" << fid << " 流量已从 t=" << t_low
-                  << " 转移至 t=" << t_high << " (Δq=" << deltaQ << ")\n";
+    UAV_LOG(CubeOptimizer, Debug) << "  ✅ Flow#" << fid << " 流量已从 t=" << t_low
+                                  << " 转移至 t=" << t_high << " (Δq=" << deltaQ << ")\n";
 }
 
 /* ------------------- 调试打印 ------------------- */
 void CubeOptimizer::logTableSummary(const std::string& name, const Table& tbl) const {
-    std::cout << "\n--- [" << name << "] ---\n";
-    for (const auto& [fid, row] : tbl) {
-        std::cout << "Flow#" << fid << ":\n";
-        for (const auto& [t, cell] : row) {
+    if (!UAV_LOG_ON(CubeOptimizer, Trace)) return;
+    Log::Line line(LogLevel::Trace);
+    line << "\n--- [" << name << "] ---\n";
+    for (int fi = 0; fi < (int)network_.flows.size(); ++fi) {
+        bool header = false;
+        for (int t = 0; t < tbl.T; ++t) {
+            const auto& cell = tbl.at(fi, t);
             if (!cell.valid) continue;
-            std::cout << "  t=" << std::setw(2) << t
-                      << " q=" << std::setw(6) << std::fixed << std::setprecision(2) << cell.q
-                      << " score=" << std::setw(8) << std::setprecision(3) << cell.score
-                      << " eff=" << std::setw(7) << std::setprecision(3) << cell.eff
-                      << " end=(" << cell.endXY.first << "," << cell.endXY.second << ")\n";
+            if (!header) {
+                line << "Flow#" << network_.flows[fi].id << ":\n";
+                header = true;
+            }
+            line << "  t=" << std::setw(2) << t
+                 << " q=" << std::setw(6) << std::fixed << std::setprecision(2) << cell.q
+                 << " score=" << std::setw(8) << std::setprecision(3) << cell.score
+                 << " eff=" << std::setw(7) << std::setprecision(3) << cell.eff
+                 << " end=(" << cell.endXY.first << "," << cell.endXY.second << ")\n";
         }
     }
 }
 
 const Flow* CubeOptimizer::findFlow(int fid) const {
-    for (const auto& f : network_.flows)
-        if (f.id == fid) return &f;
-    return nullptr;
+    return network_.flowById(fid);
 }
 
 std::optional<Ligne> CubeOptimizer::computeBestPotentialLigne(int fid, int t) const {
@@ -579,7 +630,7 @@ std::optional<Ligne> CubeOptimizer::computeBestPotentialLigne(int fid, int t) co
     double rem  = getFlowTotalSize(network_, fid);
 
     LigneFinder finder(network_, *flowPtr, t, bw,
-                       lastXY, nextXY, kCount, nState, rem);
+                       lastXY, nextXY, kCount, nState, rem, deadline_, nodeBudget_);
     auto lignes = finder.runAStarOnce();
     const Ligne* bestLine = nullptr;
     double bestEff = -1e18;
@@ -621,6 +672,7 @@ bool CubeOptimizer::applyDirectReplacement(int fid, int t, double desiredQ) {
 
     newL.flowId = fid;
     auto& sl = cube_.slices[t];
+    markSliceDirty(t);
     sl.lignes.erase(std::remove_if(sl.lignes.begin(), sl.lignes.end(),
                                    [&](const Ligne& L){ return L.flowId == fid; }),
                     sl.lignes.end());
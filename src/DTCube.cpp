@@ -1,87 +1,128 @@
 #include "DTCube.h"
+#include "Deadline.h"
+#include "ThreadPool.h"
+#include "Log.h"
+#include "Metrics.h"
 
 #include <limits>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <iostream>
 #include <iomanip>
 
 using XY = std::pair<int,int>;
 
-// ====== 日志开关（需要静默时改为 false 即可，不影响逻辑）======
-static constexpr bool LF_DEBUG = false;
-
-DTCubeBuilder::DTCubeBuilder(Network& net)
-    : network(net), T(net.T) {}
+DTCubeBuilder::DTCubeBuilder(const Network& net, const CubeBuildOptions& options)
+    : network(net), T(net.T), options(options) {
+    if (this->options.beamWidth < 1) this->options.beamWidth = 1;
+}
 
 Cube DTCubeBuilder::build() {
-    if (LF_DEBUG) std::cout << "=== 开始构建 DTCube ===" << std::endl;
+    return options.mode == CubeSearchMode::Beam ? buildBeam() : buildDfs();
+}
 
-    // 初始全局状态
-    std::map<int,double> remaining;
-    std::map<int,XY>     lastLanding;
-    std::map<int,XY>     nextLanding;
-    std::map<int,int>    changeCount;
-    std::map<int,int>    neighborState;
-
-    for (const auto& f : network.flows) {
-        remaining[f.id]   = f.size;
-        lastLanding[f.id] = {-1,-1};
-        nextLanding[f.id] = {-1,-1};
-        changeCount[f.id] = 0;
-        neighborState[f.id] = 1;
+/**
+ * @brief 叶子结果登记器：多线程共享的最优得分 / 最优路径
+ *
+ * - 得分保存在 atomic 中，明显更差的叶子无需加锁即可丢弃；
+ * - 只有可能更新最优解时才加锁比较并复制路径；
+ * - 决胜规则等价于串行 DFS 的“先到先得 + 严格大于才替换”：
+ *   同分时分叉路径（forkPath）字典序更小者胜，即串行中先被访问的叶子；
+ *   同一分叉路径内部是串行执行的，保持先到者。
+ */
+class DTCubeBuilder::BestRegister {
+public:
+    void offer(double score, const std::vector<int>& forkPath, const std::vector<Slice>& path) {
+        if (has_.load(std::memory_order_acquire) &&
+            score < score_.load(std::memory_order_relaxed))
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        const bool better = !has_.load(std::memory_order_relaxed)
+                         || score > bestScore_
+                         || (score == bestScore_ && forkPath < bestFork_);
+        if (!better) return;
+        bestScore_ = score;
+        bestFork_  = forkPath;
+        bestPath_  = path;
+        score_.store(score, std::memory_order_relaxed);
+        has_.store(true, std::memory_order_release);
     }
 
+    bool has() const { return has_.load(std::memory_order_acquire); }
+
+    // 时间预算耗尽且尚无叶子时，只允许一个线程做贪心补全，其余分支直接返回
+    bool claimFallback() { return !fallback_.exchange(true, std::memory_order_acq_rel); }
+    std::vector<Slice>& path() { return bestPath_; }
+
+private:
+    std::atomic<bool>   has_{false};
+    std::atomic<bool>   fallback_{false};
+    std::atomic<double> score_{-std::numeric_limits<double>::infinity()};
+    std::mutex          mutex_;
+    double              bestScore_{-std::numeric_limits<double>::infinity()};
+    std::vector<int>    bestFork_;
+    std::vector<Slice>  bestPath_;
+};
+
+bool DTCubeBuilder::parallel() const {
+    return options.pool != nullptr && options.pool->size() > 1;
+}
+
+Cube DTCubeBuilder::buildDfs() {
+    UAV_LOG(DTCube, Debug) << "=== 开始构建 DTCube ===\n";
+
+    // 初始全局状态
+    FlowStateVector state(network);
+
     std::vector<Slice> currentPath;
-    std::vector<Slice> bestPath;
-    double bestScore = -std::numeric_limits<double>::infinity();
+    std::vector<int> forkPath;
+    BestRegister best;
 
-    dfs(0, currentPath, 0.0, bestScore, bestPath,
-        remaining, lastLanding, nextLanding, changeCount, neighborState);
+    dfs(0, currentPath, 0.0, best, state, forkPath);
 
     Cube cube(T);
-    for (const auto& s : bestPath) cube.addSlice(s);
+    for (const auto& s : best.path()) cube.addSlice(s);
     return cube;
 }
 
 void DTCubeBuilder::dfs(int t,
                         std::vector<Slice>& currentPath,
                         double currentScore,
-                        double& bestScore,
-                        std::vector<Slice>& bestPath,
-                        std::map<int,double> remaining,
-                        std::map<int,XY>    lastLanding,
-                        std::map<int,XY>    nextLanding,
-                        std::map<int,int>   changeCount,
-                        std::map<int,int>   neighborState)
+                        BestRegister& best,
+                        FlowStateVector& state,
+                        std::vector<int>& forkPath)
 {
-    if (LF_DEBUG) std::cout << "[递归] 时刻 t=" << t << " 开始运行" << std::endl;
+    UAV_LOG(DTCube, Trace) << "[递归] 时刻 t=" << t << " 开始运行\n";
 
     // 终止
-    if (t >= T || allFinished(remaining)) {
-        if (currentScore > bestScore || bestPath.empty()) {
-            bestScore = currentScore;
-            bestPath  = currentPath;
-        }
+    if (t >= T || state.allFinished()) {
+        best.offer(currentScore, forkPath, currentPath);
+        return;
+    }
+
+    // 时间预算耗尽：已有完整方案则直接收工，否则从此处贪心补全出第一个方案
+    if (expired(options.deadline)) {
+        if (!best.has() && best.claimFallback())
+            completeGreedily(t, currentPath, currentScore, best, state, forkPath);
         return;
     }
 
     // 1) 构造带宽图
-    auto bw = makeBandwidthMap(t);
+    const auto& bw = makeBandwidthGrid(t);
 
     // 2) 生成候选切片
-    SlicePlanner planner(network, remaining, lastLanding, nextLanding,
-                         changeCount, neighborState, t, bw);
+    SlicePlanner planner(network, state, t, bw, options.pool, options.deadline, options.nodeBudget);
     auto candidates = planner.planAllSlices();
 
-    if (LF_DEBUG)
-        std::cout << "  → SlicePlanner 返回了 " << candidates.size() << " 个 Slice" << std::endl;
+    UAV_LOG(DTCube, Trace) << "  → SlicePlanner 返回了 " << candidates.size() << " 个 Slice\n";
 
     if (candidates.empty()) {
         Slice empty = makeEmptySlice(t);
         currentPath.push_back(empty);
-        dfs(t+1, currentPath, currentScore, bestScore, bestPath,
-            remaining, lastLanding, nextLanding, changeCount, neighborState);
+        dfs(t+1, currentPath, currentScore, best, state, forkPath);
         currentPath.pop_back();
         return;
     }
@@ -92,31 +133,186 @@ void DTCubeBuilder::dfs(int t,
               });
     const int BEAM = 20;
     if ((int)candidates.size() > BEAM){
-        std::cout << "=== Slice候选人数>20!!! ===" << "t=" << t <<"BEAN=" << candidates.size() << std::endl;
+        UAV_LOG(DTCube, Debug) << "=== Slice候选人数>20!!! ===" << "t=" << t <<"BEAN=" << candidates.size() << '\n';
+        Metrics::add(MetricCounter::BeamTruncations);
+        Metrics::add(MetricCounter::BeamDropped, candidates.size() - BEAM);
         candidates.resize(BEAM);
     }
-    // 3) 遍历候选
+
+    // 3a) 分叉层：每个候选子树带着自己的状态副本并行展开
+    if (parallel() && t < options.forkDepth && candidates.size() > 1) {
+        options.pool->parallelFor((int)candidates.size(), [&](int c) {
+            const Slice& s = candidates[c];
+            FlowStateVector childState = state;
+            childState.commit();
+            updateStateWithSlice(s, childState);
+
+            std::vector<Slice> childPath = currentPath;
+            childPath.push_back(s);
+            std::vector<int> childFork = forkPath;
+            childFork.push_back(c);
+            dfs(t+1, childPath, currentScore + computeSliceScore(s),
+                best, childState, childFork);
+        });
+        return;
+    }
+
+    // 3b) 遍历候选
     for (const auto& s : candidates) {
         double sliceScore = computeSliceScore(s);
 
-        auto rem2 = remaining;
-        auto last2 = lastLanding;
-        auto chg2  = changeCount;
-        updateStateWithSlice(s, rem2, last2, chg2);
+        const size_t undoMark = state.mark();
+        updateStateWithSlice(s, state);
 
         currentPath.push_back(s);
         dfs(t+1, currentPath, currentScore + sliceScore,
-            bestScore, bestPath, rem2, last2, nextLanding, chg2, neighborState);
+            best, state, forkPath);
         currentPath.pop_back();
+
+        state.rollback(undoMark);
     }
 }
 
-std::map<XY,double> DTCubeBuilder::makeBandwidthMap(int t) const {
-    std::map<XY,double> bw;
-    for (const auto& u : network.uavs) {
-        bw[{u.x, u.y}] = u.bandwidthAt(t);
+void DTCubeBuilder::completeGreedily(int t,
+                                     std::vector<Slice>& currentPath,
+                                     double currentScore,
+                                     BestRegister& best,
+                                     FlowStateVector& state,
+                                     const std::vector<int>& forkPath)
+{
+    const size_t undoMark = state.mark();
+    const size_t depth = currentPath.size();
+    for (; t < T && !state.allFinished(); ++t) {
+        SlicePlanner planner(network, state, t, makeBandwidthGrid(t), nullptr, options.deadline, options.nodeBudget);
+        Slice s = planner.planGreedySlice();
+        currentScore += computeSliceScore(s);
+        updateStateWithSlice(s, state);
+        currentPath.push_back(std::move(s));
+    }
+    best.offer(currentScore, forkPath, currentPath);
+    currentPath.resize(depth);
+    state.rollback(undoMark);
+}
+
+/**
+ * @brief 逐层束搜索：每个时刻扩展全部存活状态，按累计得分保留前 beamWidth 个
+ *
+ * - 切片以父指针形式存入 nodes，只有最终最佳状态才回溯为完整路径；
+ * - 已完成（全部流传完）的状态原样进入下一层，不再追加切片；
+ * - 同分按生成顺序（父状态顺序、候选得分降序）决胜，结果确定。
+ */
+Cube DTCubeBuilder::buildBeam() {
+    const int W = options.beamWidth;
+
+    struct Node  { Slice slice; int parent; };
+    struct State { FlowStateVector flows; double score; int node; };
+    // 子状态在被选中前只记录“父状态 + 候选切片”，避免为落选者复制 FlowStateVector
+    struct Child { int parent; int cand; double score; };
+
+    std::vector<Node> nodes;
+    std::vector<State> frontier;
+    frontier.push_back({FlowStateVector(network), 0.0, -1});
+
+    int tailFrom = T;   // 时间预算耗尽时尚未展开的第一个时刻
+    for (int t = 0; t < T; ++t) {
+        bool anyActive = false;
+        for (const auto& st : frontier) if (!st.flows.allFinished()) { anyActive = true; break; }
+        if (!anyActive) break;
+        if (expired(options.deadline)) {
+            tailFrom = t;
+            break;
+        }
+
+        const auto& bw = makeBandwidthGrid(t);
+
+        // 1) 为每个存活状态生成候选（每个父状态最多 W 个子状态可能入选）；
+        //    各父状态互不依赖，有线程池时并行规划，结果按下标存放
+        std::vector<std::vector<Slice>> candsOf(frontier.size());
+        auto planOne = [&](int i) {
+            const State& st = frontier[i];
+            if (st.flows.allFinished()) return;
+            SlicePlanner planner(network, st.flows, t, bw, options.pool, options.deadline, options.nodeBudget);
+            auto cands = planner.planAllSlices();
+            if (cands.empty()) cands.push_back(makeEmptySlice(t));
+
+            std::stable_sort(cands.begin(), cands.end(),
+                             [](const Slice& a, const Slice& b){
+                                 return computeSliceScore(a) > computeSliceScore(b);
+                             });
+            if ((int)cands.size() > W) {
+                Metrics::add(MetricCounter::BeamTruncations);
+                Metrics::add(MetricCounter::BeamDropped, cands.size() - W);
+                cands.resize(W);
+            }
+            candsOf[i] = std::move(cands);
+        };
+        if (parallel()) options.pool->parallelFor((int)frontier.size(), planOne);
+        else for (int i = 0; i < (int)frontier.size(); ++i) planOne(i);
+
+        std::vector<Child> children;
+        for (int i = 0; i < (int)frontier.size(); ++i) {
+            const State& st = frontier[i];
+            if (st.flows.allFinished()) {
+                children.push_back({i, -1, st.score});
+                continue;
+            }
+            for (int c = 0; c < (int)candsOf[i].size(); ++c)
+                children.push_back({i, c, st.score + computeSliceScore(candsOf[i][c])});
+        }
+
+        // 2) 保留累计得分最高的 W 个
+        std::stable_sort(children.begin(), children.end(),
+                         [](const Child& a, const Child& b){ return a.score > b.score; });
+        if ((int)children.size() > W) {
+            Metrics::add(MetricCounter::BeamTruncations);
+            Metrics::add(MetricCounter::BeamDropped, children.size() - W);
+            children.resize(W);
+        }
+
+        UAV_LOG(DTCube, Debug) << "[束搜索] t=" << t << " 存活状态=" << children.size() << "\n";
+
+        // 3) 物化入选子状态
+        std::vector<State> next;
+        next.reserve(children.size());
+        for (const auto& ch : children) {
+            const State& parent = frontier[ch.parent];
+            if (ch.cand < 0) {
+                next.push_back(parent);
+                continue;
+            }
+            const Slice& s = candsOf[ch.parent][ch.cand];
+            State child{parent.flows, ch.score, (int)nodes.size()};
+            updateStateWithSlice(s, child.flows);
+            child.flows.commit();
+            nodes.push_back({s, parent.node});
+            next.push_back(std::move(child));
+        }
+        frontier = std::move(next);
     }
-    return bw;
+
+    // 选出累计得分最高者（同分取靠前者），沿父指针回溯
+    int best = 0;
+    for (int i = 1; i < (int)frontier.size(); ++i)
+        if (frontier[i].score > frontier[best].score) best = i;
+
+    // 时间预算耗尽：最佳状态从 tailFrom 起贪心补全
+    State& winner = frontier[best];
+    for (int t = tailFrom; t < T && !winner.flows.allFinished(); ++t) {
+        SlicePlanner planner(network, winner.flows, t, makeBandwidthGrid(t), nullptr, options.deadline, options.nodeBudget);
+        Slice s = planner.planGreedySlice();
+        updateStateWithSlice(s, winner.flows);
+        nodes.push_back({std::move(s), winner.node});
+        winner.node = (int)nodes.size() - 1;
+    }
+
+    Cube cube(T);
+    for (int n = winner.node; n >= 0; n = nodes[n].parent)
+        cube.addSlice(nodes[n].slice);
+    return cube;
+}
+
+const BandwidthGrid& DTCubeBuilder::makeBandwidthGrid(int t) const {
+    return network.bandwidthAt(t);
 }
 
 double DTCubeBuilder::computeSliceScore(const Slice& s) {
@@ -125,29 +321,15 @@ double DTCubeBuilder::computeSliceScore(const Slice& s) {
     return total;
 }
 
-void DTCubeBuilder::updateStateWithSlice(const Slice& s,
-                                         std::map<int,double>& remaining,
-                                         std::map<int,XY>&    lastLanding,
-                                         std::map<int,int>&   changeCount)
+void DTCubeBuilder::updateStateWithSlice(const Slice& s, FlowStateVector& state) const
 {
     for (const auto& L : s.lignes) {
-        remaining[L.flowId] = std::max(0.0, remaining[L.flowId] - L.q);
-        if (!L.pathXY.empty()) {
-            auto [ex, ey] = L.pathXY.back();
-            auto last = lastLanding[L.flowId];
-            if (last.first != -1 && (last.first != ex || last.second != ey)) {
-                changeCount[L.flowId] += 1;
-            }
-            lastLanding[L.flowId] = {ex, ey};
-        }
+        int idx = network.flowIndex(L.flowId);
+        if (idx < 0) continue;
+        state.consume(idx, L.q, L.pathXY.empty() ? nullptr : &L.pathXY.back());
     }
 }
 
-bool DTCubeBuilder::allFinished(const std::map<int,double>& remaining) {
-    for (auto& kv : remaining) if (kv.second > 1e-9) return false;
-    return true;
-}
-
 Slice DTCubeBuilder::makeEmptySlice(int t) const {
     Slice empty(t);
     return empty;
@@ -0,0 +1,62 @@
+#include "DistanceField.h"
+
+#include <algorithm>
+#include <mutex>
+
+DistanceField::DistanceField(const BandwidthGrid& bw, int m1, int n1, int m2, int n2)
+    : N_(bw.height()),
+      dist_(static_cast<size_t>(bw.size()), UNREACHABLE) {
+    const int M = bw.width();
+    std::vector<int> queue;
+    queue.reserve(dist_.size());
+
+    for (int x = std::max(m1, 0); x <= std::min(m2, M - 1); ++x) {
+        for (int y = std::max(n1, 0); y <= std::min(n2, N_ - 1); ++y) {
+            if (bw(x, y) <= 0.0) continue;
+            dist_[bw.index(x, y)] = 0;
+            queue.push_back(bw.index(x, y));
+        }
+    }
+
+    static constexpr int DX[4] = {1, -1, 0, 0};
+    static constexpr int DY[4] = {0, 0, 1, -1};
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const int idx = queue[head];
+        const int x = idx / N_, y = idx % N_;
+        const uint16_t next = static_cast<uint16_t>(dist_[idx] + 1);
+        for (int k = 0; k < 4; ++k) {
+            const int nx = x + DX[k], ny = y + DY[k];
+            if (!bw.inGrid(nx, ny)) continue;
+            const int nidx = bw.index(nx, ny);
+            if (dist_[nidx] != UNREACHABLE || bw(nx, ny) <= 0.0) continue;
+            dist_[nidx] = next;
+            queue.push_back(nidx);
+        }
+    }
+}
+
+std::shared_ptr<const DistanceField>
+DistanceFieldCache::get(const BandwidthTimeline& timeline, int t,
+                        int m1, int n1, int m2, int n2) const {
+    const int phase = ((t % BandwidthTimeline::PERIOD) + BandwidthTimeline::PERIOD) % BandwidthTimeline::PERIOD;
+    // 矩形坐标与相位打包为 64 位键（网格边长 < 4096）
+    auto pack = [](int v) { return static_cast<uint64_t>(static_cast<uint16_t>(v)); };
+    const uint64_t key = (pack(m1) << 52) ^ (pack(n1) << 36) ^ (pack(m2) << 20) ^ (pack(n2) << 4)
+                       ^ static_cast<uint64_t>(phase);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = fields_.find(key);
+        if (it != fields_.end()) return it->second;
+    }
+
+    auto field = std::make_shared<const DistanceField>(timeline.at(phase), m1, n1, m2, n2);
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (cells_ + field->cells() > MAX_CELLS) {
+        fields_.clear();
+        cells_ = 0;
+    }
+    auto [it, inserted] = fields_.try_emplace(key, field);
+    if (inserted) cells_ += field->cells();
+    return it->second;
+}
@@ -0,0 +1,46 @@
+#include "FlowState.h"
+#include <algorithm>
+
+FlowStateVector::FlowStateVector(const Network& net) {
+    const size_t n = net.flows.size();
+    remaining.resize(n);
+    lastLanding.assign(n, XY{-1,-1});
+    nextLanding.assign(n, XY{-1,-1});
+    changeCount.assign(n, 0);
+    neighborState.assign(n, 1);
+    for (size_t i = 0; i < n; ++i) remaining[i] = net.flows[i].size;
+    recount();
+}
+
+void FlowStateVector::consume(int idx, double q, const XY* end) {
+    journal_.push_back({idx, remaining[idx], lastLanding[idx], changeCount[idx]});
+
+    bool wasFinished = finished(remaining[idx]);
+    remaining[idx] = std::max(0.0, remaining[idx] - q);
+    if (!wasFinished && finished(remaining[idx])) --unfinished_;
+
+    if (end) {
+        const XY& last = lastLanding[idx];
+        if (last.first != -1 && (last.first != end->first || last.second != end->second)) {
+            changeCount[idx] += 1;
+        }
+        lastLanding[idx] = *end;
+    }
+}
+
+void FlowStateVector::rollback(size_t mark) {
+    while (journal_.size() > mark) {
+        const UndoEntry& e = journal_.back();
+        bool wasFinished = finished(remaining[e.idx]);
+        remaining[e.idx]   = e.remaining;
+        lastLanding[e.idx] = e.lastLanding;
+        changeCount[e.idx] = e.changeCount;
+        if (wasFinished && !finished(e.remaining)) ++unfinished_;
+        journal_.pop_back();
+    }
+}
+
+void FlowStateVector::recount() {
+    unfinished_ = static_cast<int>(std::count_if(remaining.begin(), remaining.end(),
+                                                 [](double r){ return !finished(r); }));
+}
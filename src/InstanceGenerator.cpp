@@ -0,0 +1,168 @@
+#include "InstanceGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <vector>
+
+GeneratorSpec GeneratorSpec::maxSpec() {
+    GeneratorSpec spec;
+    spec.M = 69;
+    spec.N = 69;
+    spec.T = 499;
+    spec.flows = 4999;
+    spec.landingMin = 1;
+    spec.landingMax = 8;
+    return spec;
+}
+
+namespace {
+
+/// mt19937 原始输出之上的确定性取值
+class Rng {
+public:
+    explicit Rng(uint32_t seed) : gen_(seed) {}
+
+    int pick(int lo, int hi) {   // [lo, hi]
+        if (hi <= lo) return lo;
+        return lo + static_cast<int>(gen_() % static_cast<uint32_t>(hi - lo + 1));
+    }
+
+    double unit() { return gen_() / 4294967296.0; }   // [0, 1)
+
+    // 区间 [lo, hi] 内按 u^skew 取整
+    int skewed(double lo, double hi, double skew) {
+        const double u = std::pow(unit(), skew > 0.0 ? skew : 1.0);
+        return static_cast<int>(std::floor(lo + (hi - lo + 1.0) * u));
+    }
+
+private:
+    std::mt19937 gen_;
+};
+
+} // namespace
+
+InstanceGenerator::InstanceGenerator(const GeneratorSpec& spec)
+    : spec_(spec) {
+    spec_.M = std::max(1, spec_.M);
+    spec_.N = std::max(1, spec_.N);
+    spec_.T = std::max(1, spec_.T);
+    spec_.flows = std::max(0, spec_.flows);
+    spec_.phaseCount = std::clamp(spec_.phaseCount, 1, 10);
+    spec_.phaseBlock = std::max(1, spec_.phaseBlock);
+    if (spec_.bMax < spec_.bMin) std::swap(spec_.bMin, spec_.bMax);
+    if (spec_.sizeMax < spec_.sizeMin) std::swap(spec_.sizeMin, spec_.sizeMax);
+    spec_.landingMin = std::clamp(spec_.landingMin, 1, std::min(spec_.M, spec_.N));
+    spec_.landingMax = std::clamp(spec_.landingMax, spec_.landingMin, std::min(spec_.M, spec_.N));
+    if (spec_.distanceMax < spec_.distanceMin) spec_.distanceMax = spec_.distanceMin;
+}
+
+Network InstanceGenerator::generate() const {
+    const GeneratorSpec& s = spec_;
+    Rng rng(s.seed);
+
+    Network net;
+    net.M = s.M;
+    net.N = s.N;
+    net.T = s.T;
+    net.FN = s.flows;
+
+    // 1) 相位：每个 phaseBlock 方块一个相位
+    const int bx = (s.M + s.phaseBlock - 1) / s.phaseBlock;
+    const int by = (s.N + s.phaseBlock - 1) / s.phaseBlock;
+    std::vector<int> blockPhase(static_cast<size_t>(bx) * by);
+    for (auto& p : blockPhase) p = rng.pick(0, s.phaseCount - 1);
+
+    // 2) UAV：输入文件中按 x 外层、y 内层排列
+    net.uavs.reserve(static_cast<size_t>(s.M) * s.N);
+    int id = 0;
+    for (int x = 0; x < s.M; ++x) {
+        for (int y = 0; y < s.N; ++y) {
+            const double B = rng.skewed(s.bMin, s.bMax, s.bSkew);
+            const int phi = blockPhase[static_cast<size_t>(x / s.phaseBlock) * by + y / s.phaseBlock];
+            net.uavs.emplace_back(id++, x, y, B, phi);
+        }
+    }
+
+    // 3) Flow
+    const int startMax = std::clamp(s.startMax < 0 ? s.T / 4 : s.startMax, 0, s.T - 1);
+    net.flows.reserve(s.flows);
+    for (int f = 0; f < s.flows; ++f) {
+        const int sx = rng.pick(0, s.M - 1);
+        const int sy = rng.pick(0, s.N - 1);
+        const int side = rng.pick(s.landingMin, s.landingMax);
+
+        int lx, ly;   // 落地区域左上角
+        if (s.distanceMin < 0) {
+            lx = rng.pick(0, s.M - side);
+            ly = rng.pick(0, s.N - side);
+        } else {
+            // 沿能容纳该位移的方向放置：正向时矩形近边（左上角）距起点 dx，
+            // 负向时近边是右下角，故左上角再退 side-1 格
+            const int dist = rng.pick(s.distanceMin, s.distanceMax);
+            const int dx = rng.pick(0, dist);
+            const int dy = dist - dx;
+            lx = (sx + dx <= s.M - side) ? sx + dx : sx - dx - (side - 1);
+            ly = (sy + dy <= s.N - side) ? sy + dy : sy - dy - (side - 1);
+            // 两个方向都放不下时贴边，此时实际距离小于 dist（矩形可能覆盖起点）
+            lx = std::clamp(lx, 0, s.M - side);
+            ly = std::clamp(ly, 0, s.N - side);
+        }
+
+        const int start = std::min(startMax, rng.skewed(0, startMax, s.startSkew));
+        const double size = rng.skewed(s.sizeMin, s.sizeMax, 1.0);
+        net.flows.emplace_back(f + 1, sx, sy, start, size,
+                               lx, ly, lx + side - 1, ly + side - 1);
+    }
+
+    // 4) 走廊：只保留各流路线附近的带宽
+    if (s.corridor >= 0) {
+        std::vector<char> open(static_cast<size_t>(s.M) * s.N, 0);
+        auto openAround = [&](int cx, int cy) {
+            for (int x = std::max(0, cx - s.corridor); x <= std::min(s.M - 1, cx + s.corridor); ++x)
+                for (int y = std::max(0, cy - s.corridor); y <= std::min(s.N - 1, cy + s.corridor); ++y)
+                    open[static_cast<size_t>(x) * s.N + y] = 1;
+        };
+        for (const auto& fl : net.flows) {
+            const int xstep = fl.m1 >= fl.x ? 1 : -1;
+            for (int x = fl.x; x != fl.m1 + xstep; x += xstep) openAround(x, fl.y);
+            const int ystep = fl.n1 >= fl.y ? 1 : -1;
+            for (int y = fl.y; y != fl.n1 + ystep; y += ystep) openAround(fl.m1, y);
+            for (int x = fl.m1; x <= fl.m2; ++x)
+                for (int y = fl.n1; y <= fl.n2; ++y) openAround(x, y);
+        }
+        for (auto& u : net.uavs)
+            if (!open[static_cast<size_t>(u.x) * s.N + u.y]) u.B = 0.0;
+    }
+
+    net.buildIndex();
+    return net;
+}
+
+void InstanceGenerator::writeInput(const Network& net, std::ostream& out) {
+    std::string buf;
+    buf.reserve(net.uavs.size() * 12 + net.flows.size() * 32 + 32);
+    auto num = [&buf](long long v) { buf += std::to_string(v); };
+
+    num(net.M); buf += ' '; num(net.N); buf += ' ';
+    num(static_cast<long long>(net.flows.size())); buf += ' '; num(net.T); buf += '\n';
+    for (const auto& u : net.uavs) {
+        num(u.x); buf += ' '; num(u.y); buf += ' ';
+        num(std::llround(u.B)); buf += ' '; num(u.phi); buf += '\n';
+    }
+    for (const auto& f : net.flows) {
+        num(f.id); buf += ' '; num(f.x); buf += ' '; num(f.y); buf += ' ';
+        num(f.startTime); buf += ' '; num(std::llround(f.size)); buf += ' ';
+        num(f.m1); buf += ' '; num(f.n1); buf += ' ';
+        num(f.m2); buf += ' '; num(f.n2); buf += '\n';
+    }
+    out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+}
+
+bool InstanceGenerator::writeFile(const std::string& path) const {
+    std::ofstream fout(path);
+    if (!fout.is_open()) return false;
+    writeInput(generate(), fout);
+    return static_cast<bool>(fout);
+}
@@ -5,8 +5,8 @@
 /**
  * @brief 计算当前位置到落地区域最近点的曼哈顿距离
  */
-static double predictRemainingDistance(int currentX, int currentY,
-                                       int m1, int n1, int m2, int n2)
+double Ligne::remainingDistance(int currentX, int currentY,
+                                int m1, int n1, int m2, int n2)
 {
     if (currentX >= m1 && currentX <= m2 &&
         currentY >= n1 && currentY <= n2)
@@ -31,15 +31,11 @@ Ligne::Ligne()
       landed(false), score(0.0) {}
 
 // ======================== 得分计算函数 ========================
-double Ligne::computeScore(int currentX, int currentY,
-                        int landingX1, int landingY1,
-                        int landingX2, int landingY2,
-                        double alpha)
+double Ligne::evaluateScore(double Q_total, int t, int t_start, double Tmax,
+                            double q, double distance, bool landed,
+                            double Dremain, double alpha)
 {
-    if (Q_total <= 0.0) {
-        score = 0.0;
-        return score;
-    }
+    if (Q_total <= 0.0) return 0.0;
 
     // ===== 1️⃣ U2G Traffic Score =====
     double U2G = (q > 0.0 ? (q / Q_total) : 0.0);
@@ -53,81 +49,35 @@ double Ligne::computeScore(int currentX, int currentY,
     if (landed) {
         Dist = (q / Q_total) * std::pow(2.0, -alpha * distance);
     } else {
-        // 以路径末端为“当前点”估计剩余距离
-        int cx = currentX, cy = currentY;
-        if (!pathXY.empty()) {
-            cx = pathXY.back().first;
-            cy = pathXY.back().second;
-        }
-        double Dremain = predictRemainingDistance(cx, cy,
-                                                  landingX1, landingY1,
-                                                  landingX2, landingY2);
         double effectiveQ   = std::min(Q_total, q + Dremain);
         double effectiveDist = distance + Dremain;
         Dist = (effectiveQ / Q_total) * std::pow(2.0, -alpha * effectiveDist);
     }
 
     // ===== ✅ 综合得分 =====
-    score = 100.0 * (0.4 * U2G + 0.2 * Delay + 0.3 * Dist);
-    return static_cast<int>(score);
-}
-
-// ======================== 追加节点（不立即评分） ========================
-double Ligne::addPathUav(int x, int y, double q_u) {
-    // 1) 新点带宽为 0 → 失败
-    if (q_u <= 0.0) return -1;
-
-    // 2) 不允许重复出现
-    if (pathContains(pathXY, x, y)) return -1;
-
-    // 3) 必须与“最后一个节点”4 邻接（如果已有路径）
-    if (!pathXY.empty()) {
-        auto [lx, ly] = pathXY.back();
-        if (!isNeighbor4(lx, ly, x, y)) return -1;
-    }
-
-    // 4) 不允许与“除最后一个节点外”的任意旧节点 4 邻接（避免贴边/绕回）
-    if (adjacentToAnyExceptLast(pathXY, x, y)) return -1;
-
-    // 5) 通过校验：插入节点，更新距离（= pathXY.size() - 1）
-    pathXY.emplace_back(x, y);
-    distance = std::max(0, static_cast<int>(pathXY.size()) - 1);
-
-    // 6) 更新 q（瓶颈），以新增点的带宽 q_u 约束
-    if (q <= 0.0) q = std::min(q_u, remainingD);
-    else if (q_u < q) q = q_u;
-
-    // 可选：保持 bandwidth 与 q 同步为瓶颈
-    if (bandwidth <= 0.0) bandwidth = q;
-    else bandwidth = std::min(bandwidth, q);
-
-    // 此函数不负责更新 landed / 不立即评分
-    return score;
+    return 100.0 * (0.4 * U2G + 0.2 * Delay + 0.3 * Dist);
 }
 
-// ======================== 追加并立即评分 ========================
-double Ligne::addPathUav(int x, int y, double q_u,
-                      int currentX, int currentY,
-                      int landingX1, int landingY1,
-                      int landingX2, int landingY2,
-                      double alpha)
+double Ligne::computeScore(int currentX, int currentY,
+                        int landingX1, int landingY1,
+                        int landingX2, int landingY2,
+                        double alpha)
 {
-    double r = addPathUav(x, y, q_u);
-    if (r == -1) return -1;
-
-    // 更新 landed（是否已进落区）
-    if (!pathXY.empty()) {
-        auto [ex, ey] = pathXY.back();
-        landed = (ex >= landingX1 && ex <= landingX2 &&
-                  ey >= landingY1 && ey <= landingY2);
-    } else {
-        landed = false;
+    double Dremain = 0.0;
+    if (!landed) {
+        // 以路径末端为“当前点”估计剩余距离
+        int cx = currentX, cy = currentY;
+        if (!pathXY.empty()) {
+            cx = pathXY.back().first;
+            cy = pathXY.back().second;
+        }
+        Dremain = remainingDistance(cx, cy,
+                                    landingX1, landingY1,
+                                    landingX2, landingY2);
     }
-
-    // 立即计算分数并返回
-    return computeScore(currentX, currentY,
-                        landingX1, landingY1, landingX2, landingY2,
-                        alpha);
+    score = evaluateScore(Q_total, t, t_start, Tmax, q, distance, landed,
+                          Dremain, alpha);
+    return static_cast<int>(score);
 }
 
 // ======================== 导出输出函数 ========================
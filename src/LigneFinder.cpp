@@ -1,14 +1,16 @@
 #include "LigneFinder.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "DistanceField.h"
+#include "Deadline.h"
 #include <queue>
+#include <algorithm>
 #include <map>
 #include <limits>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 
-// ====== 日志开关（需要静默时改为 false 即可，不影响逻辑）======
-static constexpr bool LF_DEBUG = false;
-
 //计算落点变化次数
 int LigneFinder::computeDeltaChange(const std::pair<int,int>& currentLanding) const {
     auto isUnknown = [](const XY& p){ return p.first == -1 && p.second == -1; };
@@ -39,12 +41,10 @@ int LigneFinder::computeDeltaChange(const std::pair<int,int>& currentLanding) co
             deltaChange = 0;      // ✅ 与一边相同 → 不变
     }
 
-    if (LF_DEBUG) {
-        std::cout << "[computeDeltaChange] last=(" << lastLanding_.first << "," << lastLanding_.second << ") "
-                  << "curr=(" << currentLanding.first << "," << currentLanding.second << ") "
-                  << "next=(" << nextLanding_.first << "," << nextLanding_.second << ") "
-                  << " -> deltaChange=" << deltaChange << "\n";
-    }
+    UAV_LOG(LigneFinder, Trace) << "[computeDeltaChange] last=(" << lastLanding_.first << "," << lastLanding_.second << ") "
+                                << "curr=(" << currentLanding.first << "," << currentLanding.second << ") "
+                                << "next=(" << nextLanding_.first << "," << nextLanding_.second << ") "
+                                << " -> deltaChange=" << deltaChange << "\n";
 
     return deltaChange;
 }
@@ -61,21 +61,13 @@ static std::string pathToStr(const std::vector<LigneFinder::XY>& path) {
 
 // 小工具：把 Ligne 内部 pathXY 打印
 static std::string lignePathToStr(const Ligne& L) {
-    std::ostringstream oss;
-    for (size_t i = 0; i < L.pathXY.size(); ++i) {
-        oss << "(" << L.pathXY[i].first << "," << L.pathXY[i].second << ")";
-        if (i + 1 < L.pathXY.size()) oss << "->";
-    }
-    return oss.str();
+    return pathToStr(L.pathXY);
 }
 
 // 取 (x,y) 的临时可用带宽
 double LigneFinder::bwAt(int x, int y) const {
-    auto it = bw_.find({x,y});
-    double val = (it == bw_.end() ? 0.0 : it->second);
-    if (LF_DEBUG) {
-        std::cout << "[bwAt] (" << x << "," << y << ") -> " << val << " Mbps\n";
-    }
+    double val = bw_.at(x, y);
+    UAV_LOG(LigneFinder, Trace) << "[bwAt] (" << x << "," << y << ") -> " << val << " Mbps\n";
     return val;
 }
 
@@ -86,19 +78,18 @@ std::vector<LigneFinder::XY> LigneFinder::neighbors4(int x, int y) const {
     if (inGrid(x-1,y)) res.emplace_back(x-1,y);
     if (inGrid(x,y+1)) res.emplace_back(x,y+1);
     if (inGrid(x,y-1)) res.emplace_back(x,y-1);
-    if (LF_DEBUG) {
-        std::cout << "[neighbors4] from (" << x << "," << y << ") -> ";
-        for (auto& p : res) std::cout << "(" << p.first << "," << p.second << ") ";
-        std::cout << "\n";
+    if (UAV_LOG_ON(LigneFinder, Trace)) {
+        Log::Line line(LogLevel::Trace);
+        line << "[neighbors4] from (" << x << "," << y << ") -> ";
+        for (auto& p : res) line << "(" << p.first << "," << p.second << ") ";
+        line << "\n";
     }
     return res;
 }
 
 bool LigneFinder::inGrid(int x, int y) const {
     bool ok = (x >= 0 && x < network_.M && y >= 0 && y < network_.N);
-    if (LF_DEBUG) {
-        std::cout << "[inGrid] (" << x << "," << y << ") -> " << (ok ? "OK" : "OUT") << "\n";
-    }
+    UAV_LOG(LigneFinder, Trace) << "[inGrid] (" << x << "," << y << ") -> " << (ok ? "OK" : "OUT") << "\n";
     return ok;
 }
 
@@ -106,18 +97,13 @@ bool LigneFinder::inGrid(int x, int y) const {
 double LigneFinder::deltaPenaltyForK(int k) const {
     if (k <= 1) return 0.0;
     double v = 10.0 * ( (1.0 / (k - 1)) - (1.0 / k) );  // 与你图中一致
-    if (LF_DEBUG) {
-        std::cout << "[deltaPenaltyForK] k=" << k << " -> " << v << "\n";
-    }
+    UAV_LOG(LigneFinder, Trace) << "[deltaPenaltyForK] k=" << k << " -> " << v << "\n";
     return v;
 }
 
-// ============ 工具：对“已落地”的路径施加奖惩 ============
-void LigneFinder::applyLandingAdjustment(Ligne& L) const {
-    if (L.pathXY.empty()) return;
-
-    auto [ex, ey] = L.pathXY.back();
-    int deltaChange = computeDeltaChange({ex, ey});  // ✅ 统一调用通用函数
+// ============ 工具：落点 end 的历史变化惩罚 ============
+double LigneFinder::landingPenalty(const XY& end) const {
+    int deltaChange = computeDeltaChange(end);       // ✅ 统一调用通用函数
     int k = landingChangeCount_;                     // 已发生变化次数
 
     double totalPenalty = 0.0;
@@ -128,15 +114,17 @@ void LigneFinder::applyLandingAdjustment(Ligne& L) const {
         totalPenalty += deltaPenaltyForK(k + 2);
     }
 
-    L.score -= totalPenalty;
+    UAV_LOG(LigneFinder, Trace) << "[landingPenalty] flow#" << flow_.id
+                                << " deltaChange=" << deltaChange
+                                << " k=" << k
+                                << " totalPenalty=" << totalPenalty << "\n";
+    return totalPenalty;
+}
 
-    if (LF_DEBUG) {
-        std::cout << "[applyLandingAdjustment] flow#" << L.flowId
-                  << " deltaChange=" << deltaChange
-                  << " k=" << k
-                  << " totalPenalty=" << totalPenalty
-                  << " -> newScore=" << L.score << "\n";
-    }
+// ============ 工具：对“已落地”的路径施加奖惩 ============
+void LigneFinder::applyLandingAdjustment(Ligne& L) const {
+    if (L.pathXY.empty()) return;
+    L.score -= landingPenalty(L.pathXY.back());
 }
 
 // ============ 工具：由当前 best 计算动态阈值 ============
@@ -150,10 +138,8 @@ double LigneFinder::computeThresholdFromBest(const Ligne& best, int neighborStat
     int deltaChange = computeDeltaChange({bx, by});
     // ----------- case: 两边都确定（最稳定，阈值 = 最高分） -----------
     if (neighborState == 2) {
-        if (LF_DEBUG) {
-            std::cout << "[computeThresholdFromBest] flow#" << best.flowId
-                      << " neighborState=2 (both fixed) -> threshold=max=" << best.score << "\n";
-        }
+        UAV_LOG(LigneFinder, Trace) << "[computeThresholdFromBest] flow#" << best.flowId
+                                    << " neighborState=2 (both fixed) -> threshold=max=" << best.score << "\n";
         return best.score;
     }
 
@@ -183,33 +169,85 @@ double LigneFinder::computeThresholdFromBest(const Ligne& best, int neighborStat
 
     double threshold = best.score + thrPenalty;
 
-    if (LF_DEBUG) {
-        std::cout << "[computeThresholdFromBest] flow#" << best.flowId
-                  << " k=" << k
-                  << " deltaChange=" << deltaChange
-                  << " neighborState=" << neighborState
-                  << " thrPenalty=" << thrPenalty
-                  << " -> threshold=" << threshold << "\n";
-    }
+    UAV_LOG(LigneFinder, Trace) << "[computeThresholdFromBest] flow#" << best.flowId
+                                << " k=" << k
+                                << " deltaChange=" << deltaChange
+                                << " neighborState=" << neighborState
+                                << " thrPenalty=" << thrPenalty
+                                << " -> threshold=" << threshold << "\n";
 
     return threshold;
 }
 
 
+// ============ 路径池：合法性检查与物化 ============
+bool LigneFinder::canExtend(const uint8_t* onPath, int lastX, int lastY, int x, int y) const {
+    // 末端由调用方保证与 (x,y) 4 邻接；规则本身见 Ligne::breaksLoopRule
+    const int N = network_.N;
+    auto contains = [&](int px, int py) {
+        return inGrid(px, py) && onPath[px * N + py] != 0;
+    };
+    return !Ligne::breaksLoopRule(x, y, lastX, lastY, contains);
+}
+
+Ligne LigneFinder::materialize(const std::vector<SearchNode>& pool, int idx,
+                               double remainingD) const {
+    const SearchNode& n = pool[idx];
+    Ligne L;
+    L.flowId     = flow_.id;
+    L.t          = t_;
+    L.t_start    = flow_.startTime;
+    L.Q_total    = flow_.size;
+    L.remainingD = remainingD;
+    L.pathXY.resize(static_cast<size_t>(n.distance) + 1);
+    int pos = n.distance;
+    for (int i = idx; i >= 0; i = pool[i].parent)
+        L.pathXY[pos--] = {pool[i].x, pool[i].y};
+    L.distance  = n.distance;
+    L.bandwidth = n.bandwidth;
+    L.q         = n.q;
+    L.landed    = n.landed;
+    L.score     = n.score;
+    return L;
+}
+
+// 小工具：把路径池中某节点的路径打印
+static std::string nodePathToStr(const std::vector<LigneFinder::XY>& rev) {
+    std::vector<LigneFinder::XY> path(rev.rbegin(), rev.rend());
+    return pathToStr(path);
+}
+
 // ============ 单次 A*：一次性产出“已筛选的候选集” ============
 std::vector<Ligne> LigneFinder::runAStarOnce(const std::set<XY>& banSet) const {
-    if (LF_DEBUG) {
-        std::cout << "\n========== [runAStarOnce] START ==========\n";
-        std::cout << " Flow#" << flow_.id
-                  << " t=" << t_
-                  << " start=(" << flow_.x << "," << flow_.y << ")"
-                  << " landingRect=[(" << flow_.m1 << "," << flow_.n1 << ")-("
-                  << flow_.m2 << "," << flow_.n2 << ")]"
-                  << " lastLanding=(" << lastLanding_.first << "," << lastLanding_.second << ")"
-                  << " changeCount=" << landingChangeCount_ << "\n";
-        std::cout << " Ban size=" << banSet.size() << "\n";
+    if (UAV_LOG_ON(LigneFinder, Trace)) {
+        Log::Line line(LogLevel::Trace);
+        line << "\n========== [runAStarOnce] START ==========\n";
+        line << " Flow#" << flow_.id
+             << " t=" << t_
+             << " start=(" << flow_.x << "," << flow_.y << ")"
+             << " landingRect=[(" << flow_.m1 << "," << flow_.n1 << ")-("
+             << flow_.m2 << "," << flow_.n2 << ")]"
+             << " lastLanding=(" << lastLanding_.first << "," << lastLanding_.second << ")"
+             << " changeCount=" << landingChangeCount_ << "\n";
+        line << " Ban size=" << banSet.size() << "\n";
     }
 
+    // 搜索计数先记在局部，返回时一次性写入 Metrics（未启用时析构只做一次指针判断）
+    struct SearchStats {
+        uint64_t pops{0}, pushes{0}, prunes{0};
+        bool budgetStop{false}, deadlineStop{false};
+        ~SearchStats() {
+            if (Metrics::Collector* m = Metrics::current()) {
+                m->add(MetricCounter::AStarRuns);
+                m->add(MetricCounter::AStarPops, pops);
+                m->add(MetricCounter::AStarPushes, pushes);
+                m->add(MetricCounter::AStarPrunes, prunes);
+                if (budgetStop) m->add(MetricCounter::AStarBudgetStops);
+                if (deadlineStop) m->add(MetricCounter::AStarDeadlineStops);
+            }
+        }
+    } stats;
+
     std::vector<Ligne> candidates;                  // 结果：候选集合（已筛过）
     std::map<XY, std::vector<Ligne>> cmap;         // 落点 -> 该落点候选
     Ligne bestLigne;                                // 当前最佳
@@ -219,245 +257,306 @@ std::vector<Ligne> LigneFinder::runAStarOnce(const std::set<XY>& banSet) const {
     auto inBan = [&](int x,int y){
         if (flow_.inLandingRange(x,y)) return false; // 落区不受 ban
         bool banned = (banSet.count({x,y}) > 0);
-        if (LF_DEBUG && banned) {
-            std::cout << "  [ban] (" << x << "," << y << ") is banned, skip\n";
-        }
+        if (banned)
+            UAV_LOG(LigneFinder, Trace) << "  [ban] (" << x << "," << y << ") is banned, skip\n";
         return banned;
     };
 
     const int sx = flow_.x, sy = flow_.y;
     if (t_ < flow_.startTime) {
-        if (LF_DEBUG) {
-            std::cout << "  [early-exit] t_=" << t_ << " < startTime="
-                      << flow_.startTime << ", return empty\n";
-            std::cout << "========== [runAStarOnce] END (0 candidates) ==========\n";
+        if (UAV_LOG_ON(LigneFinder, Trace)) {
+            Log::Line line(LogLevel::Trace);
+            line << "  [early-exit] t_=" << t_ << " < startTime="
+                 << flow_.startTime << ", return empty\n";
+            line << "========== [runAStarOnce] END (0 candidates) ==========\n";
         }
         return candidates;
     }
 
-    // ---------- 开放集：score 高优先 ----------
-    std::priority_queue<Ligne> open;
-
-    // ---------- 初始化首条 Ligne ----------
-    Ligne L0;
-    L0.flowId  = flow_.id;
-    L0.t       = t_;
-    L0.t_start = flow_.startTime;
-    L0.Q_total = flow_.size;
-    if(remainingData_ !=-1)
-        L0.remainingD = remainingData_;
+    const double remainingD = (remainingData_ != -1)
+                            ? remainingData_
+                            : std::numeric_limits<double>::infinity();
 
     double bw_start = bwAt(sx, sy);
-    if (LF_DEBUG) {
-        std::cout << "  [init] start=(" << sx << "," << sy << ") bw_start=" << bw_start << "\n";
-    }
+    UAV_LOG(LigneFinder, Trace) << "  [init] start=(" << sx << "," << sy << ") bw_start=" << bw_start << "\n";
     if (bw_start <= 0.0) {
-        if (LF_DEBUG) {
-            std::cout << "  [early-exit] start bw <= 0, return empty\n";
-            std::cout << "========== [runAStarOnce] END (0 candidates) ==========\n";
+        if (UAV_LOG_ON(LigneFinder, Trace)) {
+            Log::Line line(LogLevel::Trace);
+            line << "  [early-exit] start bw <= 0, return empty\n";
+            line << "========== [runAStarOnce] END (0 candidates) ==========\n";
         }
         return candidates;  // 如需允许从 0 带宽起步，可放宽此处
     }
 
-    if (L0.addPathUav(sx, sy, bw_start, flow_.x, flow_.y, flow_.m1, flow_.n1, flow_.m2, flow_.n2, 0.1) < 0) {
-        if (LF_DEBUG) {
-            std::cout << "  [init] addPathUav(start) failed, return empty\n";
-            std::cout << "========== [runAStarOnce] END (0 candidates) ==========\n";
+    // 障碍感知的剩余跳数（只经带宽 > 0 的格）；起点到不了落地区域则无需搜索
+    const std::shared_ptr<const DistanceField> field = network_.distanceField(t_, flow_);
+    if (field && !field->reachable(sx, sy)) {
+        if (UAV_LOG_ON(LigneFinder, Trace)) {
+            Log::Line line(LogLevel::Trace);
+            line << "  [early-exit] landing rect unreachable from start, return empty\n";
+            line << "========== [runAStarOnce] END (0 candidates) ==========\n";
         }
         return candidates;
     }
-    if (LF_DEBUG) {
-        std::cout << "  [push-open] L0 path=" << lignePathToStr(L0)
-                  << " q=" << L0.q << " dist=" << L0.distance
-                  << " score=" << L0.score << " landed=" << (L0.landed?"Y":"N") << "\n";
-    }
-    open.push(L0);
-
-    // ---------- 访问剪枝：到达坐标的最高已见 score ----------
-    auto key64 = [](int x,int y)->long long { return ( (long long)y << 32 ) | (unsigned int)x; };
-    std::map<long long, double> bestSeenScore;
-    {
-        auto [ex,ey] = L0.pathXY.back();
-        bestSeenScore[key64(ex,ey)] = L0.score;
-        if (LF_DEBUG) {
-            std::cout << "  [bestSeenScore] set (" << ex << "," << ey << ")=" << L0.score << "\n";
+
+    // ---------- 路径池（每线程复用，避免每次扩展复制整条路径） ----------
+    static thread_local std::vector<SearchNode> pool;
+    static thread_local std::vector<PathLink>   trail;      // 与 pool 同下标的紧凑父链，供 markPath 回溯
+    // 路径占用标记：onPath[x*N+y] 为 1 表示该格在最近一次被扩展的路径（节点 marked）上
+    static thread_local std::vector<uint8_t>    onPath;
+    static thread_local std::vector<int>        fresh;      // markPath 的临时缓冲
+    pool.clear();
+    trail.clear();
+    const int N = network_.N;
+    onPath.assign(static_cast<size_t>(network_.M) * N, 0);
+    int marked = -1;
+
+    auto pushNode = [&](const SearchNode& n) {
+        pool.push_back(n);
+        trail.push_back({n.parent, n.x * N + n.y, n.distance});
+    };
+
+    // 把占用标记从 marked 的路径切换到 idx 的路径：两端沿父指针退到公共祖先，
+    // 先清除旧路径独有的格，再置位新路径独有的格；代价为两节点在搜索树上的距离
+    auto markPath = [&](int idx) {
+        int a = marked, b = idx;
+        fresh.clear();
+        const int depthA = a >= 0 ? trail[a].depth : -1;
+        const int depthB = trail[b].depth;
+        for (int d = depthA; d > depthB; --d) { onPath[trail[a].cell] = 0; a = trail[a].parent; }
+        for (int d = depthB; d > depthA; --d) { fresh.push_back(trail[b].cell); b = trail[b].parent; }
+        while (a != b) {
+            onPath[trail[a].cell] = 0;
+            fresh.push_back(trail[b].cell);
+            a = trail[a].parent;
+            b = trail[b].parent;
+        }
+        for (int cell : fresh) onPath[cell] = 1;
+        marked = idx;
+    };
+
+    // 由父节点 + 新格点生成子节点（评分规则同 Ligne::evaluateScore）
+    auto makeNode = [&](int parent, int x, int y, double q_u) {
+        SearchNode n;
+        n.x = x; n.y = y; n.parent = parent;
+        if (parent < 0) {
+            n.q = std::min(q_u, remainingD);
+            n.bandwidth = n.q;
+            n.distance = 0;
+        } else {
+            const SearchNode& p = pool[parent];
+            n.q = (p.q <= 0.0) ? std::min(q_u, remainingD) : std::min(p.q, q_u);
+            n.bandwidth = (p.bandwidth <= 0.0) ? n.q : std::min(p.bandwidth, n.q);
+            n.distance = p.distance + 1;
         }
+        n.landed = flow_.inLandingRange(x, y);
+        double Dremain = 0.0;
+        if (!n.landed)
+            Dremain = field ? field->at(x, y)
+                            : Ligne::remainingDistance(x, y, flow_.m1, flow_.n1, flow_.m2, flow_.n2);
+        n.score = Ligne::evaluateScore(flow_.size, t_, flow_.startTime, 10.0,
+                                       n.q, n.distance, n.landed, Dremain, 0.1);
+        return n;
+    };
+    auto pathOf = [&](int idx) {
+        std::vector<XY> rev;
+        for (int i = idx; i >= 0; i = pool[i].parent) rev.emplace_back(pool[i].x, pool[i].y);
+        return nodePathToStr(rev);
+    };
+
+    // ---------- 开放集：score 高优先 ----------
+    std::priority_queue<OpenEntry> open;
+
+    // ---------- 初始化首节点 ----------
+    pushNode(makeNode(-1, sx, sy, bw_start));
+    if (UAV_LOG_ON(LigneFinder, Trace)) {
+        Log::Line line(LogLevel::Trace);
+        const auto& n0 = pool[0];
+        line << "  [push-open] L0 path=" << pathOf(0)
+             << " q=" << n0.q << " dist=" << n0.distance
+             << " score=" << n0.score << " landed=" << (n0.landed?"Y":"N") << "\n";
     }
+    open.push({pool[0].score, 0});
+    ++stats.pushes;
 
     while (!open.empty()) {
-        Ligne cur = open.top(); open.pop();
-        if (LF_DEBUG) {
-            std::cout << "\n  [pop-open] path=" << lignePathToStr(cur)
-                      << " q=" << cur.q << " dist=" << cur.distance
-                      << " score=" << cur.score
-                      << " landed=" << (cur.landed?"Y":"N")
-                      << " threshold=" << threshold << "\n";
+        // 时间预算耗尽：不再出队，返回已收集的落地候选
+        if (stats.pops != 0 && (stats.pops & (DEADLINE_CHECK_POPS - 1)) == 0 && expired(deadline_)) {
+            UAV_LOG(LigneFinder, Debug) << "[runAStarOnce] flow " << flow_.id << " t=" << t_
+                                        << ": deadline reached after " << stats.pops << " pops\n";
+            stats.deadlineStop = true;
+            break;
         }
 
+        const int curIdx = open.top().node; open.pop();
+        ++stats.pops;
+        const SearchNode cur = pool[curIdx];
+        UAV_LOG(LigneFinder, Trace) << "\n  [pop-open] path=" << pathOf(curIdx)
+                                    << " q=" << cur.q << " dist=" << cur.distance
+                                    << " score=" << cur.score
+                                    << " landed=" << (cur.landed?"Y":"N")
+                                    << " threshold=" << threshold << "\n";
+
         // 全局阈值剪枝（队列有序，堆顶都小于阈值则直接收工）
         if (cur.score < threshold) {
-            if (LF_DEBUG) {
-        std::cout << "    [prune] cur.score=" << cur.score
-                  << " < threshold=" << threshold << " -> skip\n";
-    }
-    continue; // 仅跳过当前分支，继续其他分支
+            UAV_LOG(LigneFinder, Trace) << "    [prune] cur.score=" << cur.score
+                                        << " < threshold=" << threshold << " -> skip\n";
+            ++stats.prunes;
+            continue; // 仅跳过当前分支，继续其他分支
         }
 
         // 已落地：施加“落点历史奖惩”，并按规则尝试加入候选
-        if (cur.landed && !cur.pathXY.empty()) {
-            if (LF_DEBUG) {
-                auto [lx,ly] = cur.pathXY.back();
-                std::cout << "    [landed] at (" << lx << "," << ly << "), apply adjustment\n";
-            }
-            Ligne landed = cur;         // 拷贝，避免污染 cur（如果你想继续扩展未必要扩）
-            applyLandingAdjustment(landed);
+        if (cur.landed) {
+            const XY key{cur.x, cur.y};
+            UAV_LOG(LigneFinder, Trace) << "    [landed] at (" << cur.x << "," << cur.y << "), apply adjustment\n";
+            const double landedScore = cur.score - landingPenalty(key);
 
             // 刷新最佳 → 直接加入、重算阈值
-            if (landed.score > bestScore) {
-                bestScore = landed.score;
+            if (landedScore > bestScore) {
+                Ligne landed = materialize(pool, curIdx, remainingD);
+                landed.score = landedScore;
+                bestScore = landedScore;
                 bestLigne = landed;
-                auto key = landed.pathXY.back();
-                cmap[key].push_back(landed);
+                cmap[key].push_back(std::move(landed));
 
                 double newThr = computeThresholdFromBest(bestLigne, neighborState);
-                if (LF_DEBUG) {
-                    std::cout << "    [best-update] new bestScore=" << bestScore
-                              << "  threshold=" << newThr << "\n";
-                }
+                UAV_LOG(LigneFinder, Trace) << "    [best-update] new bestScore=" << bestScore
+                                            << "  threshold=" << newThr << "\n";
                 threshold = newThr;
-            } else if (landed.score >= threshold) {
-    // 非最佳：双条件（分数≥阈值 + 同落点更短才加入）
-    auto key = landed.pathXY.back();
-    auto& vec = cmap[key];
-
-    if (!vec.empty()) {
-        int minDist = static_cast<int>(vec.front().distance);
-        for (auto& c : vec) {
-            minDist = std::min(minDist, static_cast<int>(c.distance));
-        }
-
-        // 只在“严格更短”时加入；相同或更长一律不加
-        if (static_cast<int>(landed.distance) < minDist || 
-        (static_cast<int>(landed.distance) == minDist &&
-         std::abs(landed.q - vec.front().q) < 1e-6)) {
-            vec.push_back(landed);
-            if (LF_DEBUG) {
-                std::cout << "    [candidate-keep] score>=threshold & strictly-shorter"
-                          << "  end=(" << key.first << "," << key.second << ")"
-                          << "  dist=" << landed.distance << "  kept\n";
-            }
-        } else {
-            if (LF_DEBUG) {
-                std::cout << "    [candidate-skip] not strictly shorter at same end"
-                          << "  end=(" << key.first << "," << key.second << ")"
-                          << "  dist=" << landed.distance
-                          << "  minDist=" << minDist << "  skipped\n";
+            } else if (landedScore >= threshold) {
+                // 非最佳：双条件（分数≥阈值 + 同落点更短才加入）
+                auto& vec = cmap[key];
+
+                if (!vec.empty()) {
+                    int minDist = static_cast<int>(vec.front().distance);
+                    for (auto& c : vec) {
+                        minDist = std::min(minDist, static_cast<int>(c.distance));
+                    }
+
+                    // 只在“严格更短”时加入；相同或更长一律不加
+                    if (cur.distance < minDist ||
+                        (cur.distance == minDist &&
+                         std::abs(cur.q - vec.front().q) < 1e-6)) {
+                        Ligne landed = materialize(pool, curIdx, remainingD);
+                        landed.score = landedScore;
+                        vec.push_back(std::move(landed));
+                        UAV_LOG(LigneFinder, Trace) << "    [candidate-keep] score>=threshold & strictly-shorter"
+                                                    << "  end=(" << key.first << "," << key.second << ")"
+                                                    << "  dist=" << cur.distance << "  kept\n";
+                    } else {
+                        UAV_LOG(LigneFinder, Trace) << "    [candidate-skip] not strictly shorter at same end"
+                                                    << "  end=(" << key.first << "," << key.second << ")"
+                                                    << "  dist=" << cur.distance
+                                                    << "  minDist=" << minDist << "  skipped\n";
+                    }
+                } else {
+                    // 同落点尚无记录，直接加入
+                    Ligne landed = materialize(pool, curIdx, remainingD);
+                    landed.score = landedScore;
+                    vec.push_back(std::move(landed));
+                    UAV_LOG(LigneFinder, Trace) << "    [candidate-new] end=(" << key.first << "," << key.second
+                                                << ") added\n";
+                }
             }
-        }
-    } else {
-        // 同落点尚无记录，直接加入
-        vec.push_back(landed);
-        if (LF_DEBUG) {
-            std::cout << "    [candidate-new] end=(" << key.first << "," << key.second
-                      << ") added\n";
-        }
-    }
-}
 
             // 不再从已落地节点继续扩展（避免产生环和冗余）
             continue;
         }
 
+        // 节点预算已用尽：只收集已入队的落地节点，不再扩展
+        if (stats.budgetStop) continue;
+
         // 末端坐标
-        auto [cx, cy] = cur.pathXY.back();
-        if (LF_DEBUG) {
-            std::cout << "    [expand] from (" << cx << "," << cy << ")\n";
-        }
+        const int cx = cur.x, cy = cur.y;
+        UAV_LOG(LigneFinder, Trace) << "    [expand] from (" << cx << "," << cy << ")\n";
+        markPath(curIdx);
 
         // 扩展四邻居
         for (auto [nx, ny] : neighbors4(cx, cy)) {
             if (inBan(nx, ny)) {
-                if (LF_DEBUG) {
-                    std::cout << "      [skip] (" << nx << "," << ny << ") in banSet\n";
-                }
+                UAV_LOG(LigneFinder, Trace) << "      [skip] (" << nx << "," << ny << ") in banSet\n";
                 continue;
             }
 
             double bw_xy = bwAt(nx, ny);
             if (bw_xy <= 0.0) {
-                if (LF_DEBUG) {
-                    std::cout << "      [skip] (" << nx << "," << ny << ") bw<=0\n";
-                }
+                UAV_LOG(LigneFinder, Trace) << "      [skip] (" << nx << "," << ny << ") bw<=0\n";
                 continue;
             }
 
-            Ligne nxt = cur;
-            double rc = nxt.addPathUav(nx, ny, bw_xy, flow_.x, flow_.y, flow_.m1, flow_.n1, flow_.m2, flow_.n2, 0.1);
-            if (rc < 0) {
-                if (LF_DEBUG) {
-                    std::cout << "      [skip] addPathUav(" << nx << "," << ny << ") failed\n";
-                }
+            if (field && !field->reachable(nx, ny)) {
+                UAV_LOG(LigneFinder, Trace) << "      [skip] (" << nx << "," << ny << ") cannot reach landing rect\n";
                 continue;
             }
 
+            if (!canExtend(onPath.data(), cx, cy, nx, ny)) {
+                UAV_LOG(LigneFinder, Trace) << "      [skip] extend to (" << nx << "," << ny << ") illegal\n";
+                continue;
+            }
+
+            SearchNode nxt = makeNode(curIdx, nx, ny, bw_xy);
+
             // 阈值剪枝（无论落没落地）
             if (nxt.score < threshold) {
-                if (LF_DEBUG) {
-                    std::cout << "      [skip] nxt.score=" << nxt.score
-                              << " < threshold=" << threshold << "\n";
-                }
+                UAV_LOG(LigneFinder, Trace) << "      [skip] nxt.score=" << nxt.score
+                                            << " < threshold=" << threshold << "\n";
                 continue;
             }
 
-            // // 访问剪枝：同坐标若已有更高估值则跳过
-            // long long k = key64(nx, ny);
-            // auto it = bestSeenScore.find(k);
-            // if (it != bestSeenScore.end() && nxt.score < it->second) {
-            //     if (LF_DEBUG) {
-            //         std::cout << "      [skip] bestSeenScore[(" << nx << "," << ny
-            //                   << ")=" << it->second << "] >= nxt.score=" << nxt.score << "\n";
-            //     }
-            //     continue;
-            // }
-            // bestSeenScore[k] = nxt.score;
-
-            if (LF_DEBUG) {
-                std::cout << "      [push-open] path=" << lignePathToStr(nxt)
-                          << " q=" << nxt.q << " dist=" << nxt.distance
-                          << " score=" << nxt.score
-                          << " landed=" << (nxt.landed?"Y":"N") << "\n";
+            if (nodeBudget_ != NO_NODE_BUDGET && pool.size() >= nodeBudget_) {
+                UAV_LOG(LigneFinder, Debug) << "[runAStarOnce] flow " << flow_.id << " t=" << t_
+                                            << ": node budget " << nodeBudget_ << " reached, stop expanding\n";
+                stats.budgetStop = true;
+                break;
             }
-            open.push(nxt);
+
+            const int nxtIdx = static_cast<int>(pool.size());
+            pushNode(nxt);
+            UAV_LOG(LigneFinder, Trace) << "      [push-open] path=" << pathOf(nxtIdx)
+                                        << " q=" << nxt.q << " dist=" << nxt.distance
+                                        << " score=" << nxt.score
+                                        << " landed=" << (nxt.landed?"Y":"N") << "\n";
+            open.push({nxt.score, nxtIdx});
+            ++stats.pushes;
         }
     }
 
+    // 异常大的搜索之后释放线程局部节点池，避免长期占住峰值内存
+    if (pool.capacity() > RETAIN_NODES) {
+        std::vector<SearchNode>().swap(pool);
+        std::vector<PathLink>().swap(trail);
+    }
+
     // 展平 cmap 为结果
     for (auto& [end, vec] : cmap) {
-        candidates.insert(candidates.end(), vec.begin(), vec.end());
+        candidates.insert(candidates.end(),
+                          std::make_move_iterator(vec.begin()),
+                          std::make_move_iterator(vec.end()));
     }
     // 可选：按得分降序
     std::sort(candidates.begin(), candidates.end(),
               [](const Ligne& a, const Ligne& b){ return a.score > b.score; });
 
-    if (LF_DEBUG) {
-        std::cout << "\n========== [runAStarOnce] RESULT ==========\n";
+    if (UAV_LOG_ON(LigneFinder, Trace)) {
+        Log::Line line(LogLevel::Trace);
+        line << "\n========== [runAStarOnce] RESULT ==========\n";
         if (candidates.empty()) {
-            std::cout << "  (no candidates)\n";
+            line << "  (no candidates)\n";
         } else {
-            std::cout << "  total candidates: " << candidates.size() << "\n";
+            line << "  total candidates: " << candidates.size() << "\n";
             for (size_t i = 0; i < candidates.size(); ++i) {
                 const auto& L = candidates[i];
                 auto [ex,ey] = L.pathXY.empty() ? std::make_pair(-1,-1) : L.pathXY.back();
-                std::cout << "  #" << (i+1)
-                          << " score=" << L.score
-                          << " q=" << L.q
-                          << " dist=" << L.distance
-                          << " end=(" << ex << "," << ey << ")"
-                          << " path=" << lignePathToStr(L) << "\n";
+                line << "  #" << (i+1)
+                     << " score=" << L.score
+                     << " q=" << L.q
+                     << " dist=" << L.distance
+                     << " end=(" << ex << "," << ey << ")"
+                     << " path=" << lignePathToStr(L) << "\n";
             }
         }
-        std::cout << "========== [runAStarOnce] END ==========\n";
+        line << "========== [runAStarOnce] END ==========\n";
     }
 
     return candidates;
-}
\ No newline at end of file
+}
@@ -0,0 +1,120 @@
+#include "Log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Log {
+
+std::atomic<int> g_levels[static_cast<int>(LogModule::Count)] = {
+    static_cast<int>(LogLevel::Info),
+    static_cast<int>(LogLevel::Info),
+    static_cast<int>(LogLevel::Info),
+    static_cast<int>(LogLevel::Info),
+    static_cast<int>(LogLevel::Info),
+};
+
+namespace {
+
+std::mutex& outputMutex() {
+    static std::mutex m;
+    return m;
+}
+
+std::atomic<std::ostream*> g_sink{nullptr};
+
+std::string lower(std::string_view s) {
+    std::string r(s);
+    std::transform(r.begin(), r.end(), r.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return r;
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back())))  s.remove_suffix(1);
+    return s;
+}
+
+bool parseLevel(std::string_view text, LogLevel& out) {
+    static const std::pair<const char*, LogLevel> names[] = {
+        {"off", LogLevel::Off},     {"error", LogLevel::Error}, {"warn", LogLevel::Warn},
+        {"info", LogLevel::Info},   {"debug", LogLevel::Debug}, {"trace", LogLevel::Trace},
+    };
+    const std::string key = lower(trim(text));
+    for (const auto& [name, level] : names)
+        if (key == name) { out = level; return true; }
+    return false;
+}
+
+bool parseModule(std::string_view text, LogModule& out) {
+    static const std::pair<const char*, LogModule> names[] = {
+        {"lignefinder", LogModule::LigneFinder},
+        {"sliceplanner", LogModule::SlicePlanner},
+        {"dtcube", LogModule::DTCube},
+        {"optimizer", LogModule::CubeOptimizer},
+        {"cubeoptimizer", LogModule::CubeOptimizer},
+        {"scheduler", LogModule::Scheduler},
+    };
+    const std::string key = lower(trim(text));
+    for (const auto& [name, module] : names)
+        if (key == name) { out = module; return true; }
+    return false;
+}
+
+} // namespace
+
+void setLevel(LogModule module, LogLevel level) {
+    g_levels[static_cast<int>(module)].store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+void setLevel(LogLevel level) {
+    for (auto& l : g_levels) l.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+bool configure(std::string_view spec) {
+    // 先完整解析，全部合法后才生效
+    std::vector<std::pair<int, LogLevel>> updates;   // 模块下标，-1 表示全部
+    while (!spec.empty()) {
+        const size_t comma = spec.find(',');
+        const std::string_view item = trim(spec.substr(0, comma));
+        spec = (comma == std::string_view::npos) ? std::string_view() : spec.substr(comma + 1);
+        if (item.empty()) continue;
+
+        LogLevel level;
+        const size_t eq = item.find('=');
+        if (eq == std::string_view::npos) {
+            if (!parseLevel(item, level)) return false;
+            updates.emplace_back(-1, level);
+        } else {
+            LogModule module;
+            if (!parseModule(item.substr(0, eq), module) || !parseLevel(item.substr(eq + 1), level))
+                return false;
+            updates.emplace_back(static_cast<int>(module), level);
+        }
+    }
+
+    for (const auto& [module, level] : updates) {
+        if (module < 0) setLevel(level);
+        else            setLevel(static_cast<LogModule>(module), level);
+    }
+    return true;
+}
+
+void setSink(std::ostream* out) {
+    g_sink.store(out, std::memory_order_release);
+}
+
+Line::~Line() {
+    const std::string text = buf_.str();
+    std::ostream* sink = g_sink.load(std::memory_order_acquire);
+    std::ostream& out = (level_ <= LogLevel::Warn) ? std::cerr : (sink ? *sink : std::cout);
+
+    std::lock_guard<std::mutex> lock(outputMutex());
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+} // namespace Log
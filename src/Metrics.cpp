@@ -0,0 +1,77 @@
+#include "Metrics.h"
+
+#include <cstdio>
+
+namespace Metrics {
+
+thread_local Collector* t_current = nullptr;
+
+namespace {
+
+const char* const kCounterNames[] = {
+    "astar.runs", "astar.pops", "astar.pushes", "astar.prunes",
+    "astar.budgetStops", "astar.deadlineStops",
+    "astar.cacheHits", "astar.cacheMisses",
+    "plan.calls", "plan.candidates",
+    "dtcube.beamTruncations", "dtcube.beamDropped",
+    "optimizer.iterations", "optimizer.moves",
+};
+static_assert(sizeof(kCounterNames) / sizeof(kCounterNames[0]) ==
+              static_cast<size_t>(MetricCounter::Count), "counter names out of sync");
+
+const char* const kPhaseNames[] = { "load", "build", "optimize", "output" };
+static_assert(sizeof(kPhaseNames) / sizeof(kPhaseNames[0]) ==
+              static_cast<size_t>(MetricPhase::Count), "phase names out of sync");
+
+std::string jsonString(const std::string& s) {
+    std::string r = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '"':  r += "\\\""; break;
+            case '\\': r += "\\\\"; break;
+            case '\n': r += "\\n";  break;
+            case '\t': r += "\\t";  break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    r += buf;
+                } else {
+                    r += c;
+                }
+        }
+    }
+    return r + "\"";
+}
+
+std::string jsonNumber(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.6f", v);
+    return buf;
+}
+
+} // namespace
+
+void Collector::writeJson(std::ostream& out, const std::string& file, double score) const {
+    std::string s = "{\n  \"file\": " + jsonString(file) + ",\n";
+    s += "  \"score\": " + jsonNumber(score) + ",\n";
+
+    double total = 0.0;
+    s += "  \"phases\": {";
+    for (int p = 0; p < static_cast<int>(MetricPhase::Count); ++p) {
+        const double sec = seconds(static_cast<MetricPhase>(p));
+        total += sec;
+        s += std::string(p ? ", " : "") + "\"" + kPhaseNames[p] + "\": " + jsonNumber(sec);
+    }
+    s += ", \"total\": " + jsonNumber(total) + "},\n";
+
+    s += "  \"counters\": {";
+    for (int c = 0; c < static_cast<int>(MetricCounter::Count); ++c) {
+        s += std::string(c ? ", " : "") + "\"" + kCounterNames[c] + "\": "
+           + std::to_string(counter(static_cast<MetricCounter>(c)));
+    }
+    s += "}\n}\n";
+    out.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+} // namespace Metrics
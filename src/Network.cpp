@@ -1,37 +1,138 @@
 #include "Network.h"
+#include "DistanceField.h"
+#include "InputScanner.h"
 #include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <string>
 
 Network::Network()
     : M(0), N(0), FN(0), T(0) {}
 
 void Network::loadFromInput(std::istream& in) {
     if (!in) throw std::runtime_error("Invalid input stream");
+    std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    loadFromBuffer(text);
+}
+
+void Network::loadFromBuffer(std::string_view text) {
+    InputScanner scan(text);
 
     // 第一行：M, N, FN, T
-    in >> M >> N >> FN >> T;
+    M  = scan.next<int>("M");
+    N  = scan.next<int>("N");
+    FN = scan.next<int>("FN");
+    T  = scan.next<int>("T");
+    if (M < 0 || N < 0 || FN < 0)
+        throw std::runtime_error("line 1: negative grid size or flow count");
 
-   // 读取 M*N 个 UAV，并自动编号
+    // 读取 M*N 个 UAV，并自动编号
+    uavs.reserve(uavs.size() + static_cast<size_t>(M) * N);
     for (int i = 0; i < M * N; ++i) {
-        int x, y, phi;
-        double B;
-        in >> x >> y >> B >> phi;
+        int x      = scan.next<int>("UAV x");
+        int y      = scan.next<int>("UAV y");
+        double B   = scan.next<double>("UAV B");
+        int phi    = scan.next<int>("UAV phi");
         int id = i;  // 自动编号（从0开始）
         uavs.emplace_back(id, x, y, B, phi);
     }
-    
+
     // 读取 FN 条 Flow
+    flows.reserve(flows.size() + static_cast<size_t>(FN));
     for (int i = 0; i < FN; ++i) {
-        int id, x, y, startTime, m1, n1, m2, n2;
-        double size;
-        in >> id >> x >> y >> startTime >> size >> m1 >> n1 >> m2 >> n2;
+        int id        = scan.next<int>("flow id");
+        int x         = scan.next<int>("flow x");
+        int y         = scan.next<int>("flow y");
+        int startTime = scan.next<int>("flow t_start");
+        double size   = scan.next<double>("flow size");
+        int m1        = scan.next<int>("flow m1");
+        int n1        = scan.next<int>("flow n1");
+        int m2        = scan.next<int>("flow m2");
+        int n2        = scan.next<int>("flow n2");
         flows.emplace_back(id, x, y, startTime, size, m1, n1, m2, n2);
     }
+
+    buildIndex();
 }
 
-const UAV* Network::getUAV(int x, int y) const{
-    for (auto& u : uavs) {
-        if (u.x == x && u.y == y)
-            return &u;
+void Network::buildIndex() {
+    uavIndex_.assign(static_cast<size_t>(std::max(0, M * N)), -1);
+    for (size_t i = 0; i < uavs.size(); ++i) {
+        const auto& u = uavs[i];
+        if (u.x >= 0 && u.x < M && u.y >= 0 && u.y < N)
+            uavIndex_[u.x * N + u.y] = static_cast<int>(i);
+    }
+
+    // flowId → 下标：小的非负 id 用稠密表，其余（很大、稀疏或为负）落入哈希表；重复 id 保留首次出现
+    const size_t denseLimit = 2 * flows.size() + 1024;
+    size_t denseSize = 0;
+    for (const auto& f : flows)
+        if (f.id >= 0 && static_cast<size_t>(f.id) < denseLimit)
+            denseSize = std::max(denseSize, static_cast<size_t>(f.id) + 1);
+    flowIndexById_.assign(denseSize, -1);
+    flowIndexSparse_.clear();
+    for (size_t i = 0; i < flows.size(); ++i) {
+        const int id = flows[i].id;
+        if (id >= 0 && static_cast<size_t>(id) < denseSize) {
+            if (flowIndexById_[id] < 0) flowIndexById_[id] = static_cast<int>(i);
+        } else {
+            flowIndexSparse_.try_emplace(id, static_cast<int>(i));
+        }
     }
-    return nullptr; // 若未找到
+    indexedFlows_ = flows.size();
+
+    buildTimeline();
+}
+
+void Network::buildTimeline() {
+    timeline.build(M, N, uavs);
+    timelineBuilt_ = true;
+    timelineM_ = M;
+    timelineN_ = N;
+    timelineUavs_ = uavs.size();
+    distanceFields_ = std::make_shared<DistanceFieldCache>();
+}
+
+bool Network::timelineCurrent() const {
+    return timelineBuilt_ && timelineM_ == M && timelineN_ == N && timelineUavs_ == uavs.size();
+}
+
+const BandwidthGrid& Network::bandwidthAt(int t) const {
+    if (!timelineCurrent())
+        throw std::logic_error("Network: bandwidth timeline missing or stale, call buildIndex() after changing uavs / M / N");
+    return timeline.at(t);
+}
+
+std::shared_ptr<const DistanceField> Network::distanceField(int t, const Flow& f) const {
+    if (!distanceFields_ || !timelineCurrent()) return nullptr;
+    return distanceFields_->get(timeline, t, f.m1, f.n1, f.m2, f.n2);
+}
+
+const UAV* Network::uavAt(int x, int y) const {
+    if (x < 0 || x >= M || y < 0 || y >= N) return nullptr;
+    if (uavIndex_.size() != static_cast<size_t>(M * N)) {
+        // 未建索引（手工构造的 Network）时退化为线性查找
+        for (auto& u : uavs)
+            if (u.x == x && u.y == y) return &u;
+        return nullptr;
+    }
+    int idx = uavIndex_[x * N + y];
+    return idx < 0 ? nullptr : &uavs[idx];
+}
+
+int Network::flowIndex(int id) const {
+    if (indexedFlows_ != flows.size()) {
+        // 未建索引（手工构造的 Network，或建索引后增删了 flows）时退化为线性查找
+        for (size_t i = 0; i < flows.size(); ++i)
+            if (flows[i].id == id) return static_cast<int>(i);
+        return -1;
+    }
+    if (id >= 0 && static_cast<size_t>(id) < flowIndexById_.size()) return flowIndexById_[id];
+    auto it = flowIndexSparse_.find(id);
+    return it == flowIndexSparse_.end() ? -1 : it->second;
+}
+
+const Flow* Network::flowById(int id) const {
+    int idx = flowIndex(id);
+    return idx < 0 ? nullptr : &flows[idx];
 }
@@ -1,11 +1,18 @@
 #include "Scheduler.h"
 #include "DTCube.h"
 #include "CubeOptimizer.h"
+#include "Deadline.h"
+#include "ScoreEvaluator.h"
+#include "ThreadPool.h"
+#include "Log.h"
+#include "Metrics.h"
 #include <algorithm>
+#include <charconv>
 #include <iomanip>
 #include <map>
-#include <sstream>
+#include <memory>
 #include <cmath>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -15,101 +22,160 @@ Scheduler::Scheduler(Network& net)
 /**
  * @brief 主调度入口（当前仅做空实现）
  */
-void Scheduler::run() {
-    std::cout << "\n=== PathFinder 调度启动 ===\n";
-    std::cout << "网络尺寸: " << network.M << " x " << network.N
-              << "，流数量: " << network.FN
-              << "，时长 T=" << network.T << "\n";
+void Scheduler::run(const SchedulerOptions& options) {
+    // 计时从 run 开始；预算覆盖构建与优化两个阶段
+    const Deadline deadline(options.timeBudget);
+
+    UAV_LOG(Scheduler, Info) << "\n=== PathFinder 调度启动 ===\n"
+                             << "网络尺寸: " << network.M << " x " << network.N
+                             << "，流数量: " << network.FN
+                             << "，时长 T=" << network.T << "\n";
+    if (options.build.mode == CubeSearchMode::Beam) {
+        UAV_LOG(Scheduler, Info) << "构建方式: Beam (width=" << options.build.beamWidth << ")\n";
+    }
+    if (options.threads > 1) {
+        UAV_LOG(Scheduler, Info) << "并行线程数: " << options.threads << "\n";
+    }
+    if (deadline.limited()) {
+        UAV_LOG(Scheduler, Info) << "时间预算: " << options.timeBudget << " s\n";
+    }
 
     if (network.T <= 0) {
-        std::cerr << "⚠️ 网络未配置有效的时间长度，跳过调度。\n";
+        UAV_LOG(Scheduler, Warn) << "⚠️ 网络未配置有效的时间长度，跳过调度。\n";
         resultCube.reset();
-        std::cout << "=== 调度未执行 ===\n";
+        UAV_LOG(Scheduler, Info) << "=== 调度未执行 ===\n";
         return;
     }
 
     // Step 1: 构建基础 DTCube
-    DTCubeBuilder builder(network);
-    Cube best = builder.build();
-    resultCube = std::move(best);
-
-    // Step 2: 优化 Cube
-    CubeOptimizer optimizer(network, *resultCube);
-    Cube optimized = optimizer.optimize();
+    CubeBuildOptions buildOptions = options.build;
+    std::unique_ptr<ThreadPool> ownedPool;
+    if (!buildOptions.pool && options.threads > 1) {
+        ownedPool = std::make_unique<ThreadPool>(options.threads);
+        buildOptions.pool = ownedPool.get();
+    }
+    if (deadline.limited()) buildOptions.deadline = &deadline;
+    {
+        Metrics::PhaseTimer timer(MetricPhase::Build);
+        DTCubeBuilder builder(network, buildOptions);
+        Cube best = builder.build();
+        resultCube = std::move(best);
+    }
 
-    // ✅ 用优化结果覆盖原始 Cube
-    resultCube = std::move(optimized);
+    // Step 2: 优化 Cube（优化器持有工作副本，结果覆盖原始 Cube）；构建已耗尽预算时跳过
+    if (deadline.expired()) {
+        UAV_LOG(Scheduler, Info) << "⏱ 时间预算在构建阶段用尽，输出当前最优完整方案（跳过优化）\n";
+    } else {
+        Metrics::PhaseTimer timer(MetricPhase::Optimize);
+        CubeOptimizer optimizer(network, *resultCube, buildOptions.pool, buildOptions.deadline,
+                                buildOptions.nodeBudget);
+        Cube optimized = optimizer.optimize();
+        resultCube = std::move(optimized);
+    }
 
     // Step 3: 打印最终统计
-    std::cout << "\n================= 📊 Scoring Summary =================\n";
-    std::cout << resultCube->summary() << std::endl;
-    std::cout << "=====================================================\n";
+    UAV_LOG(Scheduler, Info) << "\n================= 📊 Scoring Summary =================\n"
+                             << resultCube->summary(network) << "\n"
+                             << "=====================================================\n"
+                             << "=== 调度完成 ===\n";
+}
+
+double Scheduler::score() const {
+    return resultCube ? ScoreEvaluator(network).score(*resultCube) : 0.0;
+}
+
+namespace {
 
-    std::cout << "=== 调度完成 ===\n";
+// 追加整数（std::to_chars，无 locale、无临时对象）
+inline void appendInt(std::string& buf, long long v) {
+    char tmp[24];
+    auto [end, ec] = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    (void)ec;
+    buf.append(tmp, end);
 }
 
+// 追加 q：按 0.1 取整，整数值不带小数位（与 std::fixed + setprecision(0/1) 逐字节一致）
+inline void appendQ(std::string& buf, double value) {
+    const double rounded = std::round(value * 10.0) / 10.0;
+    const bool isInteger = std::abs(rounded - std::round(rounded)) < 1e-6;
+    char tmp[320];   // 足够容纳任意 double 的定点表示（最大 309 位整数部分）
+    auto [end, ec] = std::to_chars(tmp, tmp + sizeof(tmp), rounded,
+                                   std::chars_format::fixed, isInteger ? 0 : 1);
+    (void)ec;
+    buf.append(tmp, end);
+}
+
+} // namespace
+
 /**
  * @brief 将调度结果输出为标准表格格式
  */
-void Scheduler::outputResult(std::ostream& out) const {
+void Scheduler::outputResult(std::ostream& out, bool echo) const {
     if (!out) {
-        std::cerr << "❌ 输出流无效，无法写入结果\n";
+        UAV_LOG(Scheduler, Error) << "❌ 输出流无效，无法写入结果\n";
         return;
     }
+    Metrics::PhaseTimer timer(MetricPhase::Output);
 
     if (!resultCube) {
-        std::cerr << "❌ 尚未执行调度，缺少可输出的 Cube\n";
+        UAV_LOG(Scheduler, Error) << "❌ 尚未执行调度，缺少可输出的 Cube\n";
         return;
     }
 
-    auto oldFlags = out.flags();
-    auto oldPrecision = out.precision();
-
-    std::map<int, std::vector<std::tuple<int, int, int, double>>> flowRecords;
+    // 按 network.flows 下标收集 (t, x, y, q)
+    using Record = std::tuple<int, int, int, double>;
+    std::vector<std::vector<Record>> flowRecords(network.flows.size());
+    size_t totalRecords = 0;
     for (const auto& slice : resultCube->slices) {
         for (const auto& ligne : slice.lignes) {
             if (ligne.pathXY.empty()) {
                 continue;
             }
+            const int fi = network.flowIndex(ligne.flowId);
+            if (fi < 0) continue;
             auto [endX, endY] = ligne.pathXY.back();
-            flowRecords[ligne.flowId].emplace_back(slice.t, endX, endY, ligne.q);
+            flowRecords[fi].emplace_back(slice.t, endX, endY, ligne.q);
+            ++totalRecords;
         }
     }
 
-    for (auto& [flowId, records] : flowRecords) {
+    for (auto& records : flowRecords) {
         std::sort(records.begin(), records.end(),
                   [](const auto& a, const auto& b) {
                       return std::get<0>(a) < std::get<0>(b);
                   });
     }
 
-    static const std::vector<std::tuple<int, int, int, double>> emptyRecords;
-
-    auto formatQ = [](double value) {
-        std::ostringstream oss;
-        const double rounded = std::round(value * 10.0) / 10.0;
-        const bool isInteger = std::abs(rounded - std::round(rounded)) < 1e-6;
-        oss << std::fixed << std::setprecision(isInteger ? 0 : 1) << rounded;
-        return oss.str();
-    };
+    std::string& buf = outputBuffer_;
+    buf.clear();
+    buf.reserve(network.flows.size() * 16 + totalRecords * 24);
 
-    for (const auto& flow : network.flows) {
-        const auto it = flowRecords.find(flow.id);
-        const auto& records = (it != flowRecords.end()) ? it->second : emptyRecords;
+    for (size_t fi = 0; fi < network.flows.size(); ++fi) {
+        const auto& flow = network.flows[fi];
+        const auto& records = flowRecords[fi];
 
-        out << flow.id << ' ' << records.size() << '\n';
-        std::cout << "Flow " << flow.id << " records: " << records.size() << '\n';
+        appendInt(buf, flow.id);
+        buf += ' ';
+        appendInt(buf, static_cast<long long>(records.size()));
+        buf += '\n';
+        if (echo) std::cout << "Flow " << flow.id << " records: " << records.size() << '\n';
 
         for (const auto& [t, x, y, q] : records) {
-            const auto formattedQ = formatQ(q);
-            out << t << ' '
-                << x << ' '
-                << y << ' '
-                << formattedQ << '\n';
-            std::cout << "  t=" << t << ", UAV(" << x << "," << y << "), q="
-                      << formattedQ << " Mbps\n";
+            appendInt(buf, t);
+            buf += ' ';
+            appendInt(buf, x);
+            buf += ' ';
+            appendInt(buf, y);
+            buf += ' ';
+            const size_t qPos = buf.size();
+            appendQ(buf, q);
+            if (echo) {
+                std::cout << "  t=" << t << ", UAV(" << x << "," << y << "), q="
+                          << std::string_view(buf).substr(qPos) << " Mbps\n";
+            }
+            buf += '\n';
         }
     }
-    out.flags(oldFlags);
-    out.precision(oldPrecision);
+
+    out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
 }
@@ -0,0 +1,165 @@
+#include "ScoreEvaluator.h"
+#include "InputScanner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <tuple>
+
+ScoreEvaluator::ScoreEvaluator(const Network& net)
+    : network_(net) {}
+
+void ScoreEvaluator::reset(bool validate, double slack) {
+    acc_.assign(network_.flows.size(), Acc{});
+    validate_ = validate;
+    slack_ = slack;
+    violations_ = 0;
+    firstViolation_.clear();
+    if (validate_)
+        usage_.assign(static_cast<size_t>(std::max(network_.T, 0)) * network_.M * network_.N, 0.0);
+}
+
+void ScoreEvaluator::flag(const std::string& what) {
+    if (violations_++ == 0) firstViolation_ = what;
+}
+
+void ScoreEvaluator::add(int fi, int t, int x, int y, double q) {
+    const Flow& f = network_.flows[fi];
+    Acc& a = acc_[fi];
+
+    if (validate_) {
+        auto where = [&] {
+            return "flow " + std::to_string(f.id) + " t=" + std::to_string(t)
+                 + " (" + std::to_string(x) + "," + std::to_string(y) + ")";
+        };
+        if (t < f.startTime || t >= network_.T) {
+            flag(where() + ": time outside [t_start, T)");
+        } else if (!f.inLandingRange(x, y)) {
+            flag(where() + ": landing outside [m1,n1]-[m2,n2]");
+        } else if (const UAV* u = network_.uavAt(x, y)) {
+            double& used = usage_[(static_cast<size_t>(t) * network_.M + x) * network_.N + y];
+            used += q - slack_;
+            if (used > u->bandwidthAt(t) + EPS)
+                flag(where() + ": exceeds U2G bandwidth");
+        } else {
+            flag(where() + ": no UAV at landing point");
+        }
+        if (q < 0.0) flag(where() + ": negative rate");
+    }
+
+    a.sumQ += q;
+    ++a.records;
+    a.delay += T_MAX / (t - f.startTime + T_MAX) * q;
+    a.distance += q * std::pow(2.0, -ALPHA * (std::abs(x - f.x) + std::abs(y - f.y)));
+    if (a.lastT >= 0 && (x != a.lastX || y != a.lastY)) ++a.k;
+    a.lastT = t;
+    a.lastX = x;
+    a.lastY = y;
+}
+
+double ScoreEvaluator::finishTotal() const {
+    double weighted = 0.0, totalQ = 0.0;
+    for (size_t fi = 0; fi < acc_.size(); ++fi) {
+        const double Q = network_.flows[fi].size;
+        if (Q <= 0.0) continue;
+        const Acc& a = acc_[fi];
+        const double flowScore = 100.0 * (0.4 * std::min(1.0, a.sumQ / Q) +
+                                          0.2 * a.delay / Q +
+                                          0.3 * a.distance / Q +
+                                          0.1 / a.k);
+        weighted += Q * flowScore;
+        totalQ += Q;
+    }
+    return totalQ > 0.0 ? weighted / totalQ : 0.0;
+}
+
+ScoreReport ScoreEvaluator::finish() {
+    ScoreReport report;
+    report.flows.resize(acc_.size());
+    for (size_t fi = 0; fi < acc_.size(); ++fi) {
+        const Flow& f = network_.flows[fi];
+        const Acc& a = acc_[fi];
+        if (validate_ && a.sumQ > f.size + EPS + slack_ * a.records)
+            flag("flow " + std::to_string(f.id) + ": transmitted more than Q_total");
+        if (f.size <= 0.0) continue;
+
+        FlowScore& fs = report.flows[fi];
+        fs.traffic  = std::min(1.0, a.sumQ / f.size);
+        fs.delay    = a.delay / f.size;
+        fs.distance = a.distance / f.size;
+        fs.k        = a.k;
+        fs.total    = 100.0 * (0.4 * fs.traffic + 0.2 * fs.delay + 0.3 * fs.distance + 0.1 / fs.k);
+    }
+    report.total = finishTotal();
+    report.violations = violations_;
+    report.firstViolation = firstViolation_;
+    return report;
+}
+
+double ScoreEvaluator::score(const Cube& cube) {
+    reset(false, 0.0);
+    for (const auto& slice : cube.slices) {
+        for (const auto& L : slice.lignes) {
+            if (L.pathXY.empty()) continue;
+            const int fi = network_.flowIndex(L.flowId);
+            if (fi < 0) continue;
+            const auto [x, y] = L.pathXY.back();
+            add(fi, slice.t, x, y, L.q);
+        }
+    }
+    return finishTotal();
+}
+
+ScoreReport ScoreEvaluator::evaluate(const Cube& cube, bool validate) {
+    reset(validate, 0.0);
+    for (const auto& slice : cube.slices) {
+        for (const auto& L : slice.lignes) {
+            if (L.pathXY.empty()) continue;
+            const int fi = network_.flowIndex(L.flowId);
+            if (fi < 0) {
+                if (validate_) flag("unknown flow " + std::to_string(L.flowId));
+                continue;
+            }
+            const auto [x, y] = L.pathXY.back();
+            add(fi, slice.t, x, y, L.q);
+        }
+    }
+    return finish();
+}
+
+ScoreReport ScoreEvaluator::evaluateOutput(std::string_view text, bool validate) {
+    // 输出中 z 按 0.1 取整，每条记录最多偏差 0.05
+    reset(validate, validate ? 0.05 : 0.0);
+
+    using Record = std::tuple<int, int, int, double>;
+    std::vector<Record> records;
+    InputScanner scan(text);
+    while (!scan.atEnd()) {
+        const int id = scan.next<int>("flow id");
+        const int p  = scan.next<int>("record count");
+        records.clear();
+        records.reserve(std::max(p, 0));
+        for (int i = 0; i < p; ++i) {
+            const int t    = scan.next<int>("t");
+            const int x    = scan.next<int>("x");
+            const int y    = scan.next<int>("y");
+            const double z = scan.next<double>("z");
+            records.emplace_back(t, x, y, z);
+        }
+
+        const int fi = network_.flowIndex(id);
+        if (fi < 0) {
+            if (validate_) flag("unknown flow " + std::to_string(id));
+            continue;
+        }
+        // 落点变化按时间顺序统计；调度器的输出已按 t 排好，仅在乱序时排序
+        if (!std::is_sorted(records.begin(), records.end(),
+                            [](const Record& a, const Record& b) { return std::get<0>(a) < std::get<0>(b); })) {
+            if (validate_) flag("flow " + std::to_string(id) + ": records not in time order");
+            std::stable_sort(records.begin(), records.end(),
+                             [](const Record& a, const Record& b) { return std::get<0>(a) < std::get<0>(b); });
+        }
+        for (const auto& [t, x, y, z] : records) add(fi, t, x, y, z);
+    }
+    return finish();
+}
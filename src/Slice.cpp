@@ -1,8 +1,42 @@
 #include "Slice.h"
 #include <iomanip>
+#include <cmath>
 
 Slice::Slice(int t_) : t(t_) {}
 
+long long Slice::quantizedScore(double score) {
+    return std::llround(score * 1e6);
+}
+
+uint64_t Slice::ligneHash(const Ligne& L) {
+    // splitmix64 混合 flowId 与量化得分；signature 取其模 2^64 之和，与顺序无关且可减
+    auto mix = [](uint64_t z) {
+        z += 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    };
+    const long long qs = quantizedScore(L.score);
+    return mix(mix(static_cast<uint64_t>(static_cast<uint32_t>(L.flowId)))
+               ^ static_cast<uint64_t>(qs));
+}
+
+void Slice::pushLigne(const Ligne& L) {
+    lignes.push_back(L);
+    signature += ligneHash(L);
+}
+
+void Slice::popLigne() {
+    if (lignes.empty()) return;
+    signature -= ligneHash(lignes.back());
+    lignes.pop_back();
+}
+
+void Slice::recomputeSignature() {
+    signature = 0;
+    for (const auto& L : lignes) signature += ligneHash(L);
+}
+
 bool Slice::isSameAs(const Slice& other) const {
     if (t != other.t) return false;
     if (lignes.size() != other.lignes.size()) return false;
@@ -15,7 +49,8 @@ bool Slice::isSameAs(const Slice& other) const {
 
     for (size_t i = 0; i < A.size(); ++i) {
         if (A[i].flowId != B[i].flowId) return false;
-        if (std::abs(A[i].score - B[i].score) > 1e-6) return false;
+        // 与 ligneHash 相同的量化：等价的 Slice 必然 signature 相同，去重不会漏比
+        if (quantizedScore(A[i].score) != quantizedScore(B[i].score)) return false;
     }
     return true;
 }
@@ -1,52 +1,76 @@
 #include "SlicePlanner.h"
+#include "ThreadPool.h"
+#include "Deadline.h"
+#include "Log.h"
+#include "Metrics.h"
 #include <iostream>
 #include <algorithm>
 #include <iomanip>
-
-// ⚙️ 调试输出总开关
-#define DEBUG_SLICEPLANNER 0
+#include <cstring>
 
 using XY = std::pair<int,int>;
 
 SlicePlanner::SlicePlanner(const Network& net,
-    const std::map<int, double>& remaining,
-    const std::map<int, XY>& lastLanding,
-    const std::map<int, XY>& nextLanding,
-    const std::map<int, int>& changeCount,
-    const std::map<int, int>& neighborState,
+    const FlowStateVector& state,
     int t,
-    const std::map<XY, double>& bw)
+    const BandwidthGrid& bw,
+    ThreadPool* pool,
+    const Deadline* deadline,
+    size_t nodeBudget)
 : network_(net),
-remaining_(remaining),
-lastLanding_(lastLanding),
-nextLanding_(nextLanding), 
-changeCount_(changeCount),
-neighborState_(neighborState), 
+state_(state),
 t_(t),
-bw_(bw)
-{}
+bw_(bw),
+residual_(bw_),
+pool_(pool),
+deadline_(deadline),
+nodeBudget_(nodeBudget)
+{
+    // 正带宽格的连通分量（构造时 residual_ 尚未扣减，即 bw_ 原值）
+    const int M = bw_.width(), N = bw_.height();
+    component_.assign(static_cast<size_t>(bw_.size()), -1);
+    std::vector<int> queue;
+    int label = 0;
+    for (int start = 0; start < bw_.size(); ++start) {
+        if (component_[start] >= 0 || bw_.data()[start] <= 0.0) continue;
+        component_[start] = label;
+        queue.assign(1, start);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const int x = queue[head] / N, y = queue[head] % N;
+            const XY next[4] = {{x+1,y},{x-1,y},{x,y+1},{x,y-1}};
+            for (auto [nx, ny] : next) {
+                if (nx < 0 || nx >= M || ny < 0 || ny >= N) continue;
+                const int nidx = nx * N + ny;
+                if (component_[nidx] >= 0 || bw_.data()[nidx] <= 0.0) continue;
+                component_[nidx] = label;
+                queue.push_back(nidx);
+            }
+        }
+        ++label;
+    }
+}
 
 
 /**
  * @brief 主函数：生成所有可能的 Slice 组合
  */
 std::vector<Slice> SlicePlanner::planAllSlices() {
-#if DEBUG_SLICEPLANNER
-    std::cout << "\n========== [SlicePlanner::planAllSlices] START ==========\n";
-    std::cout << "t=" << t_ << " | total flows=" << remaining_.size() << "\n";
-    for (auto& [fid, r] : remaining_) {
-        auto itL = lastLanding_.find(fid);
-        auto itC = changeCount_.find(fid);
-        auto last = (itL != lastLanding_.end()) ? itL->second : XY{-1,-1};
-        int cc = (itC != changeCount_.end()) ? itC->second : 0;
-        std::cout << "  Flow#" << fid
-                  << "  remaining=" << r
-                  << "  lastLanding=(" << last.first << "," << last.second << ")"
-                  << "  changeCount=" << cc << "\n";
+    if (UAV_LOG_ON(SlicePlanner, Debug)) {
+        Log::Line line(LogLevel::Debug);
+        line << "\n========== [SlicePlanner::planAllSlices] START ==========\n";
+        line << "t=" << t_ << " | total flows=" << state_.size() << "\n";
+        for (int i = 0; i < state_.size(); ++i) {
+            const auto& last = state_.lastLanding[i];
+            line << "  Flow#" << network_.flows[i].id
+                 << "  remaining=" << state_.remaining[i]
+                 << "  lastLanding=(" << last.first << "," << last.second << ")"
+                 << "  changeCount=" << state_.changeCount[i] << "\n";
+        }
     }
-#endif
 
+    Metrics::add(MetricCounter::PlanCalls);
     std::vector<Slice> allSlices;
+    seenSignatures_.clear();
 
     // 依据当前剩余/带宽评估每条流，获取一组候选顺序
     auto baseOrders = computeFlowOrder();
@@ -68,11 +92,12 @@ std::vector<Slice> SlicePlanner::planAllSlices() {
     }
 
     // ============ 2️⃣ 使用固定顺序们调用递归规划 ============
-    auto initialBw = bw_;
-    Slice initSlice(t_);
+    // 每个顺序都从 bw_ 出发；递归内原地扣减，回溯时恢复，因此每轮结束 bw_ 即还原
+    Slice workSlice(t_);
     if (flowOrders.empty()) return allSlices;
     for (const auto& flowOrder : flowOrders) {
-        recursivePlan(0, flowOrder, initialBw, initSlice, allSlices);
+        if (!allSlices.empty() && expired(deadline_)) break;
+        recursivePlan(0, flowOrder, workSlice, allSlices);
     }
 
     // ============ 3️⃣ 去除空 Slice 与返回 ============
@@ -84,83 +109,192 @@ std::vector<Slice> SlicePlanner::planAllSlices() {
     //                     allSlices.end());
     // }
 
-#if DEBUG_SLICEPLANNER
-    std::cout << "\n========== [SlicePlanner::planAllSlices] END ==========\n";
-    std::cout << "  Total candidate slices: " << allSlices.size() << "\n";
-    for (size_t i = 0; i < allSlices.size(); ++i) {
-        std::cout << "  Slice#" << i+1
-                  << "  t=" << allSlices[i].t
-                  << "  lignes=" << allSlices[i].lignes.size() << "\n";
-        for (auto& L : allSlices[i].lignes) {
-            std::cout << "    Flow#" << L.flowId
-                      << "  q=" << std::fixed << std::setprecision(3) << L.q
-                      << "  score=" << std::setw(7) << std::setprecision(3) << L.score
-                      << "  end=(" << L.pathXY.back().first << "," << L.pathXY.back().second << ")\n";
+    if (UAV_LOG_ON(SlicePlanner, Debug)) {
+        Log::Line line(LogLevel::Debug);
+        line << "\n========== [SlicePlanner::planAllSlices] END ==========\n";
+        line << "  Total candidate slices: " << allSlices.size() << "\n";
+        for (size_t i = 0; i < allSlices.size(); ++i) {
+            line << "  Slice#" << i+1
+                 << "  t=" << allSlices[i].t
+                 << "  lignes=" << allSlices[i].lignes.size() << "\n";
+            for (auto& L : allSlices[i].lignes) {
+                line << "    Flow#" << L.flowId
+                     << "  q=" << std::fixed << std::setprecision(3) << L.q
+                     << "  score=" << std::setw(7) << std::setprecision(3) << L.score
+                     << "  end=(" << L.pathXY.back().first << "," << L.pathXY.back().second << ")\n";
+            }
         }
     }
-#endif
 
+    UAV_LOG(SlicePlanner, Debug) << "  A* cache: hits=" << cacheHits_ << " misses=" << cacheMisses_ << "\n";
+    Metrics::add(MetricCounter::PlanCandidates, allSlices.size());
     return allSlices;
 }
 
-std::vector<std::vector<int>> SlicePlanner::computeFlowOrder() const {
-    // ============ 1️⃣ 计算每个流的平均分并排序 ============
-    std::vector<std::pair<double, int>> flowScores; // (平均分, flowId)
+Slice SlicePlanner::planGreedySlice() {
+    Slice slice(t_);
+    // 预算已耗尽时改用限节点 A*：既不会被 deadline 截成空结果，耗时也有上界
+    const bool capped = expired(deadline_);
+    for (int i = 0; i < state_.size(); ++i) {
+        if (state_.remaining[i] <= 1e-9) continue;
+        if (network_.flows[i].startTime > t_) continue;
+
+        const LigneList found = capped ? std::make_shared<const std::vector<Ligne>>(runCappedFinder(i))
+                                       : findLignes(i);
+        const auto& lignes = *found;   // 已按得分降序
+        if (lignes.empty() || lignes.front().q <= 1e-9) continue;
+
+        const Ligne& L = lignes.front();
+        residual_.subtractPath(L.pathXY, L.q);
+        slice.pushLigne(L);
+    }
+    UAV_LOG(SlicePlanner, Debug) << "[贪心补全] t=" << t_ << " lignes=" << slice.lignes.size() << "\n";
+    return slice;
+}
 
-#if DEBUG_SLICEPLANNER
-    std::cout << "\n-- [Computing flow average scores] --\n";
-#endif
-
-    // 计算每个流的平均分
-    for (const auto& [fid, _] : remaining_) {
-        // 找到对应的 Flow 对象
-        const Flow* flowPtr = nullptr;
-        for (auto& f : network_.flows) {
-            if (f.id == fid) {
-                flowPtr = &f;
-                break;
-            }
+namespace {
+
+uint64_t splitmix(uint64_t z) {
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+SlicePlanner::SearchKey SlicePlanner::searchKey(int idx) const {
+    SearchKey key{idx,
+                  state_.lastLanding[idx], state_.nextLanding[idx],
+                  state_.changeCount[idx], state_.neighborState[idx],
+                  state_.remaining[idx],
+                  {}, 0};
+
+    // 只保留起点所在连通分量内的改动；起点无带宽时 A* 必然返回空，改动无关
+    const Flow& f = network_.flows[idx];
+    const int comp = bw_.inGrid(f.x, f.y) ? component_[bw_.index(f.x, f.y)] : -1;
+    if (comp >= 0) {
+        residual_.changedCells(changed_);
+        for (const auto& [cell, value] : changed_) {
+            if (component_[cell] != comp) continue;
+            key.cells.emplace_back(cell, value);
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            key.cellsHash = splitmix(key.cellsHash ^ splitmix(static_cast<uint64_t>(cell)) ^ bits);
         }
+    }
+    return key;
+}
+
+size_t SlicePlanner::SearchKeyHash::operator()(const SearchKey& k) const {
+    // 改动格的哈希已充分混合，只需再混入流下标与上下文
+    uint64_t h = k.cellsHash ^ (static_cast<uint64_t>(k.flow) * 0x9e3779b97f4a7c15ULL);
+    h ^= static_cast<uint64_t>(k.changeCount) << 32 ^ static_cast<uint64_t>(k.neighborState);
+    h ^= std::hash<double>()(k.remaining) * 0xbf58476d1ce4e5b9ULL;
+    h ^= (static_cast<uint64_t>(k.lastLanding.first + 1) << 48) ^ (static_cast<uint64_t>(k.lastLanding.second + 1) << 32)
+       ^ (static_cast<uint64_t>(k.nextLanding.first + 1) << 16) ^ static_cast<uint64_t>(k.nextLanding.second + 1);
+    return static_cast<size_t>(h);
+}
+
+std::vector<Ligne> SlicePlanner::runFinder(int idx) const {
+    LigneFinder finder(network_, network_.flows[idx], t_,
+                       residual_.grid(),
+                       state_.lastLanding[idx],
+                       state_.nextLanding[idx],
+                       state_.changeCount[idx],
+                       state_.neighborState[idx],
+                       state_.remaining[idx],
+                       deadline_, nodeBudget_);
+    return finder.runAStarOnce();
+}
+
+std::vector<Ligne> SlicePlanner::runCappedFinder(int idx) const {
+    LigneFinder finder(network_, network_.flows[idx], t_,
+                       residual_.grid(),
+                       state_.lastLanding[idx],
+                       state_.nextLanding[idx],
+                       state_.changeCount[idx],
+                       state_.neighborState[idx],
+                       state_.remaining[idx],
+                       nullptr, GREEDY_NODE_BUDGET);
+    return finder.runAStarOnce();
+}
+
+void SlicePlanner::cacheStore(SearchKey key, LigneList lignes) {
+    if (searchCache_.size() >= MAX_CACHE_ENTRIES) {
+        UAV_LOG(SlicePlanner, Debug) << "  A* cache full (" << searchCache_.size() << " entries), cleared\n";
+        searchCache_.clear();
+    }
+    searchCache_.try_emplace(std::move(key), std::move(lignes));
+}
+
+SlicePlanner::LigneList SlicePlanner::findLignes(int idx) {
+    SearchKey key = searchKey(idx);
+    auto it = searchCache_.find(key);
+    if (it != searchCache_.end()) {
+        ++cacheHits_;
+        Metrics::add(MetricCounter::LigneCacheHits);
+        return it->second;
+    }
+    ++cacheMisses_;
+    Metrics::add(MetricCounter::LigneCacheMisses);
+    auto lignes = std::make_shared<const std::vector<Ligne>>(runFinder(idx));
+    cacheStore(std::move(key), lignes);
+    return lignes;
+}
+
+std::vector<std::vector<int>> SlicePlanner::computeFlowOrder() {
+    // ============ 1️⃣ 计算每个流的平均分并排序 ============
+    std::vector<std::pair<double, int>> flowScores; // (平均分, flowId)
 
-        if (!flowPtr) continue;
+    UAV_LOG(SlicePlanner, Debug) << "\n-- [Computing flow average scores] --\n";
 
-        // 获取流的上下文信息
-        double remain   = remaining_.count(fid)     ? remaining_.at(fid)     : -1;
-        XY prevLanding  = lastLanding_.count(fid)   ? lastLanding_.at(fid)   : XY{-1,-1};
-        XY nextLanding  = nextLanding_.count(fid)   ? nextLanding_.at(fid)   : XY{-1,-1};
-        int change      = changeCount_.count(fid)   ? changeCount_.at(fid)   : 0;
-        int neighbor    = neighborState_.count(fid) ? neighborState_.at(fid) : 0;
+    // 计算每个流的平均分：各流只读共享 network_ / bw_，结果写入各自下标
+    const int flowCount = state_.size();
+    std::vector<double> avgScores(flowCount, 0.0);
+    std::vector<int>    candCounts(flowCount, 0);
 
-        // 创建 LigneFinder 并获取候选路径
-        LigneFinder finder(network_, *flowPtr, t_,
-                           bw_,
-                           prevLanding,
-                           nextLanding,
-                           change,
-                           neighbor,
-                           remain);
+    std::vector<std::vector<Ligne>> found(flowCount);
 
-        auto lignes = finder.runAStarOnce();
+    auto evaluateFlow = [&](int i) {
+        // 此时尚未扣减任何带宽，残余视图即 bw_
+        found[i] = runFinder(i);
+        const auto& lignes = found[i];
 
         if (lignes.empty())
-            continue;
+            return;
 
         double totalScore = 0.0;
         for (const auto& ligne : lignes) {
             totalScore += ligne.score;
         }
-        double avgScore = (lignes.empty() ? 0.0 : totalScore / lignes.size());
-
+        candCounts[i] = static_cast<int>(lignes.size());
+        avgScores[i]  = totalScore / lignes.size();
+    };
+
+    if (pool_ && pool_->size() > 1 && flowCount > 1)
+        pool_->parallelFor(flowCount, evaluateFlow);
+    else
+        for (int i = 0; i < flowCount; ++i) evaluateFlow(i);
+
+    // 候选集串行写入缓存，recursivePlan 中同一上下文的首次搜索直接命中
+    for (int i = 0; i < flowCount; ++i)
+        cacheStore(searchKey(i), std::make_shared<const std::vector<Ligne>>(std::move(found[i])));
+    cacheMisses_ += flowCount;
+    Metrics::add(MetricCounter::LigneCacheMisses, flowCount);
+
+    // 按流下标顺序收集，保证与串行结果一致
+    for (int i = 0; i < flowCount; ++i) {
+        const double avgScore = avgScores[i];
         if (avgScore <= 0.0)  // 过滤掉得分为0（无可落地价值）的流
             continue;
 
+        const int fid = network_.flows[i].id;
         flowScores.emplace_back(avgScore, fid);
 
-#if DEBUG_SLICEPLANNER
-        std::cout << "  Flow#" << fid
-                  << "  candidates=" << lignes.size()
-                  << "  avgScore=" << std::fixed << std::setprecision(3) << avgScore << "\n";
-#endif
+        UAV_LOG(SlicePlanner, Debug) << "  Flow#" << fid
+                                     << "  candidates=" << candCounts[i]
+                                     << "  avgScore=" << std::fixed << std::setprecision(3) << avgScore << "\n";
     }
 
     if (flowScores.empty()) {
@@ -182,138 +316,121 @@ std::vector<std::vector<int>> SlicePlanner::computeFlowOrder() const {
     }
     flowOrders.push_back(std::move(highToLow));
 
-#if DEBUG_SLICEPLANNER
-    std::cout << "\n-- [Final flow order (high to low score)] --\n";
-    const auto& flowOrderDbg = flowOrders.front();
-    for (size_t i = 0; i < flowOrderDbg.size(); ++i) {
-        std::cout << "  #" << (i+1) << " Flow#" << flowOrderDbg[i]
-                  << " avgScore=" << std::fixed << std::setprecision(3) << flowScores[i].first << "\n";
+    if (UAV_LOG_ON(SlicePlanner, Debug)) {
+        Log::Line line(LogLevel::Debug);
+        line << "\n-- [Final flow order (high to low score)] --\n";
+        const auto& flowOrderDbg = flowOrders.front();
+        for (size_t i = 0; i < flowOrderDbg.size(); ++i) {
+            line << "  #" << (i+1) << " Flow#" << flowOrderDbg[i]
+                 << " avgScore=" << std::fixed << std::setprecision(3) << flowScores[i].first << "\n";
+        }
     }
-#endif
 
     return flowOrders;
 }
 
+/**
+ * @brief 若 allSlices 中尚无与 s 等价的 Slice 则加入，返回是否加入
+ */
+bool SlicePlanner::addIfNew(const Slice& s, std::vector<Slice>& allSlices) {
+    auto range = seenSignatures_.equal_range(s.signature);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (allSlices[it->second].isSameAs(s)) return false;
+    }
+    seenSignatures_.emplace(s.signature, allSlices.size());
+    allSlices.push_back(s);
+    return true;
+}
+
 /**
  * @brief 递归生成 Slice 组合
  */
 void SlicePlanner::recursivePlan(int index,
                                  const std::vector<int>& flowOrder,
-                                 std::map<XY, double> currentBw,
-                                 Slice currentSlice,
+                                 Slice& currentSlice,
                                  std::vector<Slice>& allSlices)
 {
     if (index >= (int)flowOrder.size()) {
         // 所有 flow 都尝试完毕，保存一个 Slice
-        bool duplicate = false;
-        for (auto& s : allSlices) {
-            if (s.isSameAs(currentSlice)) {
-#if DEBUG_SLICEPLANNER
-                std::cout << "    [-] Duplicate Slice skipped\n";
-#endif
-                duplicate = true;
-                break;
-            }
-        }
-        if (!duplicate) {
-#if DEBUG_SLICEPLANNER
-            std::cout << "    [+] New Slice accepted, total lignes=" << currentSlice.lignes.size() << "\n";
-#endif
-            allSlices.push_back(currentSlice);
+        if (addIfNew(currentSlice, allSlices)) {
+            UAV_LOG(SlicePlanner, Trace) << "    [+] New Slice accepted, total lignes=" << currentSlice.lignes.size() << "\n";
+        } else {
+            UAV_LOG(SlicePlanner, Trace) << "    [-] Duplicate Slice skipped\n";
         }
         return;
     }
 
     // ============ 1️⃣ 当前流 ============
     int fid = flowOrder[index];
-    const Flow* flowPtr = nullptr;
-    for (auto& f : network_.flows)
-        if (f.id == fid) { flowPtr = &f; break; }
+    const int idx = network_.flowIndex(fid);
 
-    if (!flowPtr) return; // 防御
+    if (idx < 0 || idx >= state_.size()) return; // 防御
 
     // ============ 2️⃣ 获取当前流的上下文信息 ============
-    double remain   = remaining_.count(fid)     ? remaining_.at(fid)     : -1;
-    XY prevLanding  = lastLanding_.count(fid)   ? lastLanding_.at(fid)   : XY{-1,-1};
-    XY nextLanding  = nextLanding_.count(fid)   ? nextLanding_.at(fid)   : XY{-1,-1};
-    int change      = changeCount_.count(fid)   ? changeCount_.at(fid)   : 0;
-    int neighbor    = neighborState_.count(fid) ? neighborState_.at(fid) : 0;
-
-#if DEBUG_SLICEPLANNER
-    std::cout << "\n  [Flow#" << fid << "] remain=" << remain
-              << "  prevLanding=(" << prevLanding.first << "," << prevLanding.second << ")"
-              << "  nextLanding=(" << nextLanding.first << "," << nextLanding.second << ")"
-              << "  changeCount=" << change
-              << "  neighborState=" << neighbor << "\n";
-#endif
-
-    // ============ 3️⃣ 调用 LigneFinder ============
-    LigneFinder finder(network_, *flowPtr, t_,
-                       currentBw,
-                       prevLanding,
-                       nextLanding,
-                       change,
-                       neighbor,
-                       remain);
-
-    auto lignes = finder.runAStarOnce();
-
-#if DEBUG_SLICEPLANNER
-    std::cout << "    [LigneFinder] found " << lignes.size()
-              << " lignes for flow#" << fid << "\n";
-#endif
+    double remain   = state_.remaining[idx];
+    XY prevLanding  = state_.lastLanding[idx];
+    XY nextLanding  = state_.nextLanding[idx];
+    int change      = state_.changeCount[idx];
+    int neighbor    = state_.neighborState[idx];
+
+    UAV_LOG(SlicePlanner, Trace) << "\n  [Flow#" << fid << "] remain=" << remain
+                                 << "  prevLanding=(" << prevLanding.first << "," << prevLanding.second << ")"
+                                 << "  nextLanding=(" << nextLanding.first << "," << nextLanding.second << ")"
+                                 << "  changeCount=" << change
+                                 << "  neighborState=" << neighbor << "\n";
+
+    // ============ 3️⃣ 调用 LigneFinder（带缓存） ============
+    const LigneList found = findLignes(idx);   // 持有引用计数：递归中缓存被清空也不影响本层遍历
+    const auto& lignes = *found;
+
+    UAV_LOG(SlicePlanner, Trace) << "    [LigneFinder] found " << lignes.size()
+                                 << " lignes for flow#" << fid << "\n";
 
     if (lignes.empty()) {
-#if DEBUG_SLICEPLANNER
-        std::cout << "    [Skip] No available path for Flow#" << fid << "\n";
-#endif
+        UAV_LOG(SlicePlanner, Trace) << "    [Skip] No available path for Flow#" << fid << "\n";
         // 没有路径，也要记录当前 slice（说明这个流无法传输）
-        bool duplicate = false;
-        for (auto& s : allSlices) {
-            if (s.isSameAs(currentSlice)) {
-                duplicate = true;
-                break;
-            }
-        }
-        if (!duplicate)
-            allSlices.push_back(currentSlice);
+        addIfNew(currentSlice, allSlices);
         // 继续尝试后续 flow，允许后续仍然调度
-        recursivePlan(index+1, flowOrder, currentBw, currentSlice, allSlices);
+        recursivePlan(index+1, flowOrder, currentSlice, allSlices);
         return;
     }
 
     // ============ 4️⃣ 遍历当前流所有可行路线 ============
-    for (auto& L : lignes) {
-#if DEBUG_SLICEPLANNER
-        std::cout << "      # q=" << std::setw(6) << std::setprecision(3) << L.q
-                  << " score=" << std::setw(7) << std::setprecision(3) << L.score
-                  << " path=";
-        for (auto& [x,y] : L.pathXY) std::cout << "("<<x<<","<<y<<")->";
-        std::cout << " end=(" << L.pathXY.back().first << "," << L.pathXY.back().second << ")\n";
-#endif
-
-        // 复制带宽表并减去消耗
-        auto bwCopy = currentBw;
-        for (auto& [x,y] : L.pathXY) {
-            double before = bwCopy[{x,y}];
-            bwCopy[{x,y}] = std::max(0.0, before - L.q);
-#if DEBUG_SLICEPLANNER
-            std::cout << "      [bw-update] (" << x << "," << y << ")  "
-                      << std::fixed << std::setprecision(3)
-                      << before << "→" << bwCopy[{x,y}] << "\n";
-#endif
+    // 时间预算耗尽后只沿首条（最优）路线走到底，保证至少产出一个完整 Slice
+    for (const auto& L : lignes) {
+        if (&L != &lignes.front() && expired(deadline_)) break;
+        if (UAV_LOG_ON(SlicePlanner, Trace)) {
+            Log::Line line(LogLevel::Trace);
+            line << "      # q=" << std::setw(6) << std::setprecision(3) << L.q
+                 << " score=" << std::setw(7) << std::setprecision(3) << L.score
+                 << " path=";
+            for (auto& [x,y] : L.pathXY) line << "("<<x<<","<<y<<")->";
+            line << " end=(" << L.pathXY.back().first << "," << L.pathXY.back().second << ")\n";
+        }
+
+        // 原地扣减路径上的带宽（仅触及路径格点），回溯时恢复
+        const size_t bwMark = residual_.mark();
+        if (UAV_LOG_ON(SlicePlanner, Trace)) {
+            Log::Line line(LogLevel::Trace);
+            for (auto& [x,y] : L.pathXY) {
+                line << "      [bw-update] (" << x << "," << y << ")  "
+                     << std::fixed << std::setprecision(3)
+                     << residual_.grid().at(x,y) << "→"
+                     << std::max(0.0, residual_.grid().at(x,y) - L.q) << "\n";
+            }
         }
+        residual_.subtractPath(L.pathXY, L.q);
 
-        // 构造新的 Slice
-        Slice nextSlice = currentSlice;
-        nextSlice.lignes.push_back(L);
+        // 压入当前流的路径
+        currentSlice.pushLigne(L);
 
-#if DEBUG_SLICEPLANNER
-        std::cout << "    [Recursive → next flow] index=" << index+1
-                  << " | currentSlice lignes=" << nextSlice.lignes.size() << "\n";
-#endif
+        UAV_LOG(SlicePlanner, Trace) << "    [Recursive → next flow] index=" << index+1
+                                     << " | currentSlice lignes=" << currentSlice.lignes.size() << "\n";
 
         // 递归调用
-        recursivePlan(index+1, flowOrder, bwCopy, nextSlice, allSlices);
+        recursivePlan(index+1, flowOrder, currentSlice, allSlices);
+
+        currentSlice.popLigne();
+        residual_.rollback(bwMark);
     }
 }
\ No newline at end of file
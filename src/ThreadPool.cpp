@@ -0,0 +1,94 @@
+#include "ThreadPool.h"
+#include "Metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+ThreadPool::ThreadPool(int threads) {
+    for (int i = 1; i < threads; ++i)
+        workers_.emplace_back([this] { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& w : workers_) w.join();
+}
+
+int ThreadPool::hardwareThreads() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : static_cast<int>(n);
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) return;   // stopping_ 且无剩余任务
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        job();
+    }
+}
+
+void ThreadPool::parallelFor(int n, const std::function<void(int)>& fn) {
+    if (n <= 0) return;
+    if (workers_.empty() || n == 1) {
+        for (int i = 0; i < n; ++i) fn(i);
+        return;
+    }
+
+    // 共享状态由 shared_ptr 持有：晚出队的帮手任务可能在本函数返回后才运行，
+    // 此时它只会发现下标已取完并立即退出
+    struct Batch {
+        std::atomic<int> next{0};
+        int done{0};
+        std::exception_ptr error;
+        std::mutex m;
+        std::condition_variable cv;
+    };
+    auto batch = std::make_shared<Batch>();
+    const std::function<void(int)>* body = &fn;
+
+    // 帮手线程沿用调用者绑定的 Metrics 收集器，计数归入同一实例
+    Metrics::Collector* metrics = Metrics::current();
+
+    auto drain = [batch, body, n, metrics] {
+        Metrics::Bind bind(metrics);
+        int finished = 0;
+        for (int i; (i = batch->next.fetch_add(1)) < n; ++finished) {
+            try {
+                (*body)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(batch->m);
+                if (!batch->error) batch->error = std::current_exception();
+            }
+        }
+        if (finished == 0) return;
+        std::lock_guard<std::mutex> lock(batch->m);
+        batch->done += finished;
+        if (batch->done == n) batch->cv.notify_all();
+    };
+
+    const int helpers = std::min<int>(static_cast<int>(workers_.size()), n - 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int h = 0; h < helpers; ++h) queue_.emplace_back(drain);
+    }
+    if (helpers == 1) cv_.notify_one(); else cv_.notify_all();
+
+    // 调用者自己也取下标执行；取完后等待其他线程手上的下标完成。
+    // 正在执行的下标总由某个活动线程持有，因此等待必然结束。
+    drain();
+    std::unique_lock<std::mutex> lock(batch->m);
+    batch->cv.wait(lock, [&] { return batch->done == n; });
+    if (batch->error) std::rethrow_exception(batch->error);
+}
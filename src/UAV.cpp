@@ -9,10 +9,5 @@ UAV::UAV(int id, int x, int y, double B, int phi)
 // 0,1,8,9 -> 0 Mbps; 2,7 -> B/2; 3-6 -> B
 double UAV::bandwidthAt(int t) const {
     int modTime = (phi + t) % 10;
-    if (modTime == 0 || modTime == 1 || modTime == 8 || modTime == 9)
-        return 0.0;
-    else if (modTime == 2 || modTime == 7)
-        return B / 2.0;
-    else
-        return B;
+    return B * PHASE_FACTOR[modTime];
 }
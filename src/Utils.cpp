@@ -1,16 +1,97 @@
 #include "Utils.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define UTILS_HAVE_MMAP 1
+#endif
 
 namespace fs = std::filesystem;
 
+namespace {
+
+/**
+ * @brief 只读打开整个输入文件：POSIX 下 mmap 映射（零拷贝），其它平台整体读入内存
+ */
+class InputFile {
+public:
+    explicit InputFile(const std::string& path) {
+#ifdef UTILS_HAVE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st{};
+        if (::fstat(fd, &st) == 0) {
+            size_ = static_cast<size_t>(st.st_size);
+            if (size_ == 0) {
+                ok_ = true;
+            } else {
+                void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    map_ = p;
+                    ok_ = true;
+                }
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream fin(path, std::ios::binary);
+        if (!fin.is_open()) return;
+        buffer_.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+        ok_ = true;
+#endif
+    }
+
+    ~InputFile() {
+#ifdef UTILS_HAVE_MMAP
+        if (map_) ::munmap(map_, size_);
+#endif
+    }
+
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+
+    bool is_open() const { return ok_; }
+
+    std::string_view text() const {
+#ifdef UTILS_HAVE_MMAP
+        return map_ ? std::string_view(static_cast<const char*>(map_), size_) : std::string_view();
+#else
+        return buffer_;
+#endif
+    }
+
+private:
+    bool ok_{false};
+#ifdef UTILS_HAVE_MMAP
+    void*  map_{nullptr};
+    size_t size_{0};
+#else
+    std::string buffer_;
+#endif
+};
+
+} // namespace
+
 namespace Utils {
 
 std::vector<std::string> listInputFiles(const std::string& inputDir) {
     std::vector<std::string> files;
     if (!fs::exists(inputDir)) {
-        std::cerr << "❌ Input directory not found: " << inputDir << std::endl;
+        UAV_LOG(Scheduler, Error) << "❌ Input directory not found: " << inputDir << "\n";
         return files;
     }
 
@@ -24,22 +105,39 @@ std::vector<std::string> listInputFiles(const std::string& inputDir) {
 }
 
 bool loadNetworkFromFile(const std::string& inputPath, Network& network) {
-    std::ifstream fin(inputPath);
+    Metrics::PhaseTimer timer(MetricPhase::Load);
+    InputFile fin(inputPath);
     if (!fin.is_open()) {
-        std::cerr << "❌ Cannot open input file: " << inputPath << std::endl;
+        UAV_LOG(Scheduler, Error) << "❌ Cannot open input file: " << inputPath << "\n";
         return false;
     }
 
     try {
-        network.loadFromInput(fin);
+        network.loadFromBuffer(fin.text());
     } catch (const std::exception& e) {
-        std::cerr << "❌ Error loading file " << inputPath << ": " << e.what() << std::endl;
+        UAV_LOG(Scheduler, Error) << "❌ Error loading file " << inputPath << ": " << e.what() << "\n";
         return false;
     }
 
     return true;
 }
 
+bool scoreOutputFile(const Network& network, const std::string& outputPath, ScoreReport& report) {
+    InputFile fin(outputPath);
+    if (!fin.is_open()) {
+        UAV_LOG(Scheduler, Error) << "❌ Cannot open output file: " << outputPath << "\n";
+        return false;
+    }
+
+    try {
+        report = ScoreEvaluator(network).evaluateOutput(fin.text());
+    } catch (const std::exception& e) {
+        UAV_LOG(Scheduler, Error) << "❌ Error parsing output " << outputPath << ": " << e.what() << "\n";
+        return false;
+    }
+    return true;
+}
+
 bool runSchedulerAndSave(const Network& network, const std::string& outputPath) {
     Scheduler scheduler(const_cast<Network&>(network));  // 调度需要非const引用
     scheduler.run();
@@ -63,4 +161,119 @@ std::string makeOutputPath(const std::string& inputPath,
     return outputDir + "/" + base + "_result.txt";
 }
 
+std::string makeMetricsPath(const std::string& inputPath, const std::string& outputDir) {
+    return outputDir + "/" + fs::path(inputPath).stem().string() + "_metrics.json";
+}
+
+namespace {
+
+// 处理单个实例：Network / Scheduler 均为本函数局部对象，与其它实例互不共享
+BatchResult runOne(const std::string& inputPath, const BatchOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+
+    BatchResult result;
+    result.inputPath = inputPath;
+    result.outputPath = makeOutputPath(inputPath, options.inputDir, options.outputDir);
+
+    // 仅在开启 metrics 时绑定收集器；否则各统计点只做一次空指针判断
+    Metrics::Collector metrics;
+    Metrics::Bind bind(options.metrics ? &metrics : nullptr);
+
+    UAV_LOG(Scheduler, Info) << "\n📂 测试文件：" << inputPath << "\n";
+
+    Network network;
+    if (loadNetworkFromFile(inputPath, network)) {
+        try {
+            Scheduler scheduler(network);
+            scheduler.run(options.scheduler);
+
+            std::ofstream fout(result.outputPath);
+            if (!fout.is_open()) {
+                UAV_LOG(Scheduler, Error) << "❌ Cannot open output file: " << result.outputPath << "\n";
+            } else {
+                scheduler.outputResult(fout);
+                result.ok = static_cast<bool>(fout);
+                result.score = scheduler.score();
+                UAV_LOG(Scheduler, Info) << "✅ Result saved to: " << result.outputPath << "\n";
+            }
+        } catch (const std::exception& e) {
+            UAV_LOG(Scheduler, Error) << "❌ Scheduling failed for " << inputPath << ": " << e.what() << "\n";
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (options.metrics) {
+        const std::string metricsPath = makeMetricsPath(inputPath, options.outputDir);
+        std::ofstream mout(metricsPath);
+        metrics.writeJson(mout, inputPath, result.score);
+        if (!mout) {
+            UAV_LOG(Scheduler, Error) << "❌ Cannot write metrics file: " << metricsPath << "\n";
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+std::vector<BatchResult> runBatch(const BatchOptions& options) {
+    auto files = listInputFiles(options.inputDir);
+    std::sort(files.begin(), files.end());
+
+    std::error_code ec;
+    fs::create_directories(options.outputDir, ec);
+
+    std::vector<BatchResult> results(files.size());
+    if (files.empty()) return results;
+
+    // 每个下标只写自己的结果槽，无需加锁
+    const int workers = std::max(1, std::min<int>(options.workers, static_cast<int>(files.size())));
+    ThreadPool pool(workers);
+    pool.parallelFor(static_cast<int>(files.size()), [&](int i) {
+        results[i] = runOne(files[i], options);
+    });
+    return results;
+}
+
+void printBatchReport(const std::vector<BatchResult>& results,
+                      double wallSeconds, std::ostream& out) {
+    size_t nameWidth = 4;
+    for (const auto& r : results)
+        nameWidth = std::max(nameWidth, fs::path(r.inputPath).filename().string().size());
+
+    std::ostringstream oss;
+    oss << "\n================= 📦 Batch Summary =================\n";
+    oss << std::left << std::setw(static_cast<int>(nameWidth)) << "File"
+        << "  " << std::setw(6) << "Status"
+        << std::right << std::setw(10) << "Time(s)"
+        << std::setw(10) << "Score" << "\n";
+
+    int succeeded = 0;
+    double cpuSeconds = 0.0, scoreSum = 0.0;
+    for (const auto& r : results) {
+        oss << std::left << std::setw(static_cast<int>(nameWidth))
+            << fs::path(r.inputPath).filename().string()
+            << "  " << std::setw(6) << (r.ok ? "ok" : "FAIL")
+            << std::right << std::fixed
+            << std::setw(10) << std::setprecision(3) << r.seconds;
+        if (r.ok) oss << std::setw(10) << std::setprecision(3) << r.score;
+        else      oss << std::setw(10) << "-";
+        oss << "\n";
+
+        cpuSeconds += r.seconds;
+        if (r.ok) { ++succeeded; scoreSum += r.score; }
+    }
+
+    oss << "----------------------------------------------------\n";
+    oss << std::fixed << std::setprecision(3)
+        << "成功 " << succeeded << "/" << results.size()
+        << "，墙钟 " << wallSeconds << "s，累计 " << cpuSeconds << "s";
+    if (succeeded > 0) oss << "，平均得分 " << scoreSum / succeeded;
+    oss << "\n====================================================\n";
+
+    const std::string text = oss.str();
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
 } // namespace Utils
@@ -6,44 +6,89 @@
 #include "Network.h"
 #include "Flow.h"
 #include "UAV.h"
+#include "BandwidthGrid.h"
 #include "LigneFinder.h"
 #include "SlicePlanner.h"
 #include "Scheduler.h"
 #include "Utils.h"
+#include "Log.h"
+#include "ThreadPool.h"
 
-int runCube(){
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+void printUsage(const char* prog) {
+    std::cout << "用法: " << prog << " [-i 输入目录] [-o 输出目录] [-j 并发实例数] [-t 单实例线程数] [-b 束宽] [-d 秒] [-n 节点数] [-m]\n"
+              << "  默认: -i ../input -o ../output -j <硬件线程数> -t 1，DFS 构建（-b 改用 Beam 构建）\n"
+              << "  -d: 每个实例的时间预算（秒），到时输出当前最优完整方案\n"
+              << "  -n: 每次 A* 搜索的节点上限（默认不限）；大网格上限制内存，但可能漏掉部分候选路径\n"
+              << "  -m: 为每个输入写出 输出目录/xxx_metrics.json（阶段耗时与搜索计数）\n";
+}
+
+// 解析正整数参数；非法时返回 false
+bool parsePositive(const char* text, int& out) {
+    char* end = nullptr;
+    const long v = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || v < 1) return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+// 解析正实数参数（秒）；非法时返回 false
+bool parseSeconds(const char* text, double& out) {
+    char* end = nullptr;
+    const double v = std::strtod(text, &end);
+    if (end == text || *end != '\0' || !(v > 0.0)) return false;
+    out = v;
+    return true;
+}
+
+int runCube(int argc, char** argv){
     std::cout << "=== PathFinder A* 测试程序 ===" << std::endl;
 
-    const std::string inputDir = "../input";
-    const std::string outputDir = "../output";
+    Utils::BatchOptions options;
+    options.workers = ThreadPool::hardwareThreads();
+    int nodeBudget = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if ((arg == "-i" || arg == "--input") && hasValue) {
+            options.inputDir = argv[++i];
+        } else if ((arg == "-o" || arg == "--output") && hasValue) {
+            options.outputDir = argv[++i];
+        } else if ((arg == "-j" || arg == "--jobs") && hasValue && parsePositive(argv[i + 1], options.workers)) {
+            ++i;
+        } else if ((arg == "-t" || arg == "--threads") && hasValue && parsePositive(argv[i + 1], options.scheduler.threads)) {
+            ++i;
+        } else if ((arg == "-b" || arg == "--beam") && hasValue && parsePositive(argv[i + 1], options.scheduler.build.beamWidth)) {
+            options.scheduler.build.mode = CubeSearchMode::Beam;
+            ++i;
+        } else if ((arg == "-d" || arg == "--deadline") && hasValue && parseSeconds(argv[i + 1], options.scheduler.timeBudget)) {
+            ++i;
+        } else if ((arg == "-n" || arg == "--node-budget") && hasValue && parsePositive(argv[i + 1], nodeBudget)) {
+            options.scheduler.build.nodeBudget = static_cast<size_t>(nodeBudget);
+            ++i;
+        } else if (arg == "-m" || arg == "--metrics") {
+            options.metrics = true;
+        } else {
+            printUsage(argv[0]);
+            return arg == "-h" || arg == "--help" ? 0 : -1;
+        }
+    }
 
-    auto files = Utils::listInputFiles(inputDir);
-    if (files.empty()) {
+    const auto start = std::chrono::steady_clock::now();
+    auto results = Utils::runBatch(options);
+    if (results.empty()) {
         std::cerr << "❌ 未找到输入文件！请在 input 文件夹中放测试文件。\n";
         return -1;
     }
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    for (const auto& inputPath : files) {
-        std::cout << "\n📂 测试文件：" << inputPath << std::endl;
-
-        Network network;
-        if (!Utils::loadNetworkFromFile(inputPath, network))
-            continue;
-
-        Scheduler scheduler(network);
-        scheduler.run(); // 调用测试模式
-        
-        std::string outputPath = Utils::makeOutputPath(inputPath, inputDir, outputDir);
-        std::ofstream fout(outputPath);
-        if (!fout.is_open()) {
-            std::cerr << "❌ Cannot open output file: " << outputPath << std::endl;
-            return -1;
-        }
-
-        scheduler.outputResult(fout);
-        std::cout << "✅ Result saved to: " << outputPath << std::endl;
-
-    }
+    Utils::printBatchReport(results, wall, std::cout);
+    for (const auto& r : results)
+        if (!r.ok) return -1;
     return 0;
 }
 
@@ -73,10 +118,10 @@ void testLigneFinderSingleFlow() {
     net.flows.push_back(f1);
 
     // ===== 构造当前时刻带宽矩阵 =====
-    std::map<std::pair<int,int>, double> bw;
+    BandwidthGrid bw(net.M, net.N);
     int t = 0;
     for (const auto& uav : net.uavs) {
-        bw[{uav.x, uav.y}] = uav.bandwidthAt(t);
+        bw(uav.x, uav.y) = uav.bandwidthAt(t);
     }
 
     // ===== 创建 LigneFinder 并运行 A* =====
@@ -149,15 +194,15 @@ net.uavs.push_back(UAV(24, 4, 4, 10, 4));
 
     int currentTime = 0;
     // ✅ 3. 构建带宽矩阵
-    std::map<XY,double> bw;
+    BandwidthGrid bw(net.M, net.N);
     for (const auto& u : net.uavs)
-        bw[{u.x, u.y}] = u.bandwidthAt(currentTime);
+        bw(u.x, u.y) = u.bandwidthAt(currentTime);
 
     // ✅ 4. 打印带宽地图
     std::cout << "[DEBUG] 带宽矩阵 (t=0):\n";
     for (int y = net.N-1; y >= 0; --y) {
         for (int x = 0; x < net.M; ++x)
-            std::cout << std::setw(6) << std::fixed << std::setprecision(1) << bw[{x,y}] << " ";
+            std::cout << std::setw(6) << std::fixed << std::setprecision(1) << bw.at(x,y) << " ";
         std::cout << "\n";
     }
 
@@ -172,16 +217,12 @@ net.uavs.push_back(UAV(24, 4, 4, 10, 4));
     // ✅ 7. 测试新的 SlicePlanner
     std::cout << "\n=== SlicePlanner 测试（优化后） ===\n";
     
-    // 构建剩余数据映射
-    std::map<int, double> remainingData = {{1, 40.0}, {2, 25.0}, {3, 30.0}};
-    std::map<int, XY> lastLandingMap = {{1, {-1,-1}}, {2, {-1,-1}}, {3, {-1,-1}}};
-    std::map<int, XY> nextLandingMap = {{1, {-1,-1}}, {2, {-1,-1}}, {3, {-1,-1}}};
-    std::map<int, int> changeCountMap = {{1, 0}, {2, 0}, {3, 0}};
-    std::map<int, int> neighborStateMap = {{1, 0}, {2, 0}, {3, 0}};
-    
-    
-    SlicePlanner planner(net, remainingData, lastLandingMap, nextLandingMap, 
-                        changeCountMap, neighborStateMap, currentTime, bw);
+    // 构建逐流状态（remaining=size，落点未知，neighborState=0）
+    net.buildIndex();
+    FlowStateVector state(net);
+    std::fill(state.neighborState.begin(), state.neighborState.end(), 0);
+
+    SlicePlanner planner(net, state, currentTime, bw);
     
     std::cout << "\n>>> 执行 SlicePlanner::planAllSlices() ...\n";
     auto slices = planner.planAllSlices();
@@ -213,12 +254,17 @@ net.uavs.push_back(UAV(24, 4, 4, 10, 4));
         }
     }
 }
-int main() {
+int main(int argc, char** argv) {
+    // 日志级别：UAV_LOG=warn 或 UAV_LOG=info,optimizer=debug（见 Log.h）
+    if (const char* spec = std::getenv("UAV_LOG")) {
+        if (!Log::configure(spec))
+            std::cerr << "⚠️ 无法识别的 UAV_LOG 配置: " << spec << "\n";
+    }
 
-    int test = runCube();
+    int test = runCube(argc, argv);
 
 //   testSlicePlanner();
 
 //    testLigneFinderSingleFl();
-    return 0;
+    return test == 0 ? 0 : 1;
 }
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "Network.h"
+
+namespace {
+
+// 2×1 网格，流 id 依次给出（每条流相同：起点 (0,0)，落地 (1,0)）
+Network withFlowIds(std::initializer_list<long long> ids) {
+    std::string text = "2 1 " + std::to_string(ids.size()) + " 10\n0 0 10 3\n1 0 10 3\n";
+    for (long long id : ids) text += std::to_string(id) + " 0 0 0 10 1 0 1 0\n";
+    Network net;
+    net.loadFromBuffer(text);
+    return net;
+}
+
+} // namespace
+
+TEST(NetworkTest, FlowIndexHandlesLargeAndNegativeIds) {
+    const Network net = withFlowIds({1, 2000000000, -5, 2147483647});
+    EXPECT_EQ(net.flowIndex(1), 0);
+    EXPECT_EQ(net.flowIndex(2000000000), 1);
+    EXPECT_EQ(net.flowIndex(-5), 2);
+    EXPECT_EQ(net.flowIndex(2147483647), 3);
+    EXPECT_EQ(net.flowIndex(2), -1);
+    EXPECT_EQ(net.flowById(7), nullptr);
+}
+
+TEST(NetworkTest, DuplicateFlowIdsResolveToFirstOccurrence) {
+    const Network net = withFlowIds({3, 4, 3, 2000000000, 2000000000});
+    EXPECT_EQ(net.flowIndex(3), 0);
+    EXPECT_EQ(net.flowIndex(4), 1);
+    EXPECT_EQ(net.flowIndex(2000000000), 3);
+}
+
+TEST(NetworkTest, FlowIndexFallsBackToScanWhenFlowsChangeSize) {
+    Network net = withFlowIds({1, 2});
+    net.flows.emplace_back(9, 0, 0, 0, 10.0, 1, 0, 1, 0);
+    EXPECT_EQ(net.flowIndex(9), 2);
+    net.buildIndex();
+    EXPECT_EQ(net.flowIndex(9), 2);
+    EXPECT_EQ(net.flowIndex(1), 0);
+}
+
+TEST(NetworkTest, BandwidthAtRequiresCurrentTimeline) {
+    Network net = withFlowIds({1});
+    EXPECT_DOUBLE_EQ(net.bandwidthAt(0).at(0, 0), 10.0);   // φ=3，t=0 为满带宽
+
+    net.uavs.emplace_back(2, 0, 0, 4.0, 3);
+    EXPECT_FALSE(net.timelineCurrent());
+    EXPECT_THROW(net.bandwidthAt(0), std::logic_error);
+
+    net.buildIndex();
+    EXPECT_TRUE(net.timelineCurrent());
+    EXPECT_NO_THROW(net.bandwidthAt(0));
+}
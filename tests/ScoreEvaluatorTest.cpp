@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+#include "Cube.h"
+#include "Network.h"
+#include "ScoreEvaluator.h"
+
+namespace {
+
+// 题目示例（Docs/DocRequirement.md）：3×3 网格，B=10、φ=3，t∈[0,4) 带宽为满值 10
+constexpr std::string_view kExampleInput =
+    "3 3 2 10\n"
+    "0 0 10 3\n1 0 10 3\n2 0 10 3\n"
+    "0 1 10 3\n1 1 10 3\n2 1 10 3\n"
+    "0 2 10 3\n1 2 10 3\n2 2 10 3\n"
+    "1 0 0 0 40 0 0 2 2\n"
+    "2 0 1 2 20 0 0 2 2\n";
+
+constexpr std::string_view kExampleOutput =
+    "1 4\n0 0 0 10\n1 0 0 10\n2 0 0 10\n3 0 0 10\n"
+    "2 2\n2 0 1 10\n3 0 2 10\n";
+
+// 示例按精确值计算：97.558 与 93.088 按流量 40:20 加权（文档 96.055 来自其舍入后的中间值）
+constexpr double kExampleScore = 96.068;
+
+Network load(std::string_view text) {
+    Network net;
+    net.loadFromBuffer(text);
+    return net;
+}
+
+Ligne record(int flowId, int x, int y, double q) {
+    Ligne L;
+    L.flowId = flowId;
+    L.pathXY = {{x, y}};
+    L.q = q;
+    return L;
+}
+
+} // namespace
+
+TEST(ScoreEvaluatorTest, WorkedExampleFromOutputText) {
+    const Network net = load(kExampleInput);
+    ScoreEvaluator eval(net);
+
+    const ScoreReport report = eval.evaluateOutput(kExampleOutput);
+    EXPECT_EQ(report.violations, 0) << report.firstViolation;
+    EXPECT_NEAR(report.total, kExampleScore, 1e-3);
+
+    ASSERT_EQ(report.flows.size(), 2u);
+    EXPECT_DOUBLE_EQ(report.flows[0].traffic, 1.0);
+    EXPECT_NEAR(report.flows[0].delay, 0.8779, 1e-4);
+    EXPECT_DOUBLE_EQ(report.flows[0].distance, 1.0);
+    EXPECT_EQ(report.flows[0].k, 1);
+    EXPECT_NEAR(report.flows[0].total, 97.558, 1e-3);
+
+    EXPECT_NEAR(report.flows[1].delay, 0.9545, 1e-4);
+    EXPECT_NEAR(report.flows[1].distance, 0.9665, 1e-4);
+    EXPECT_EQ(report.flows[1].k, 2);
+}
+
+TEST(ScoreEvaluatorTest, WorkedExampleFromCube) {
+    const Network net = load(kExampleInput);
+    Cube cube(net.T);
+    for (int t = 0; t < 4; ++t) {
+        Slice s(t);
+        s.lignes.push_back(record(1, 0, 0, 10.0));
+        if (t == 2) s.lignes.push_back(record(2, 0, 1, 10.0));
+        if (t == 3) s.lignes.push_back(record(2, 0, 2, 10.0));
+        cube.addSlice(s);
+    }
+
+    ScoreEvaluator eval(net);
+    const ScoreReport report = eval.evaluate(cube);
+    EXPECT_EQ(report.violations, 0) << report.firstViolation;
+    EXPECT_NEAR(report.total, kExampleScore, 1e-3);
+    EXPECT_DOUBLE_EQ(eval.score(cube), report.total);
+
+    // 调试摘要的总分与官方评分一致
+    EXPECT_NE(cube.summary(net).find("Total score: 96.068"), std::string::npos);
+}
+
+TEST(ScoreEvaluatorTest, PartialFlowScoresTrafficRatio) {
+    const Network net = load(kExampleInput);
+    ScoreEvaluator eval(net);
+
+    // 流 1 只传了 20/40，流 2 未传输
+    const ScoreReport report = eval.evaluateOutput("1 2\n0 0 0 10\n1 0 0 10\n");
+    EXPECT_EQ(report.violations, 0) << report.firstViolation;
+    EXPECT_DOUBLE_EQ(report.flows[0].traffic, 0.5);
+    EXPECT_NEAR(report.flows[0].delay, 0.25 * (1.0 + 10.0 / 11.0), 1e-9);
+    EXPECT_DOUBLE_EQ(report.flows[0].distance, 0.5);
+    EXPECT_NEAR(report.flows[0].total,
+                100.0 * (0.4 * 0.5 + 0.2 * report.flows[0].delay + 0.3 * 0.5 + 0.1), 1e-9);
+
+    EXPECT_DOUBLE_EQ(report.flows[1].traffic, 0.0);
+    EXPECT_EQ(report.flows[1].k, 1);
+    EXPECT_NEAR(report.flows[1].total, 10.0, 1e-9);
+
+    EXPECT_NEAR(report.total, (40.0 * report.flows[0].total + 20.0 * 10.0) / 60.0, 1e-9);
+}
+
+TEST(ScoreEvaluatorTest, OutOfOrderRecordsCountLandingChangesInTimeOrder) {
+    const Network net = load(kExampleInput);
+    ScoreEvaluator eval(net);
+
+    // 文件顺序 (0,0)(0,0)(1,0) 只变化一次；按时间顺序 (0,0)@0 (1,0)@1 (0,0)@2 变化两次
+    const ScoreReport report = eval.evaluateOutput("1 3\n2 0 0 10\n0 0 0 10\n1 1 0 10\n");
+    EXPECT_EQ(report.flows[0].k, 3);
+    EXPECT_EQ(report.violations, 1);
+    EXPECT_NE(report.firstViolation.find("not in time order"), std::string::npos);
+
+    // 不校验时同样按时间顺序统计，且不报告违规
+    const ScoreReport quiet = eval.evaluateOutput("1 3\n2 0 0 10\n0 0 0 10\n1 1 0 10\n", false);
+    EXPECT_EQ(quiet.flows[0].k, 3);
+    EXPECT_EQ(quiet.violations, 0);
+}
+
+TEST(ScoreEvaluatorTest, FlagsBandwidthOverflow) {
+    const Network net = load(kExampleInput);
+    ScoreEvaluator eval(net);
+
+    const ScoreReport report = eval.evaluateOutput("1 1\n0 0 0 15\n");
+    EXPECT_EQ(report.violations, 1);
+    EXPECT_NE(report.firstViolation.find("exceeds U2G bandwidth"), std::string::npos);
+
+    // 两个流在同一 UAV 同一秒合计超过带宽（t=3 时 (0,2) 带宽为 10）
+    const ScoreReport shared = eval.evaluateOutput("1 1\n3 0 2 6\n2 1\n3 0 2 6\n");
+    EXPECT_EQ(shared.violations, 1);
+    EXPECT_NE(shared.firstViolation.find("exceeds U2G bandwidth"), std::string::npos);
+
+    // 输出保留 1 位小数，每条记录允许 0.05 的舍入误差
+    EXPECT_EQ(eval.evaluateOutput("1 1\n0 0 0 10.04\n").violations, 0);
+}
+
+TEST(ScoreEvaluatorTest, FlagsLandingOutsideRectangle) {
+    // 流 1 只能落在 (2,2)
+    const Network net = load(
+        "3 3 1 10\n"
+        "0 0 10 3\n1 0 10 3\n2 0 10 3\n"
+        "0 1 10 3\n1 1 10 3\n2 1 10 3\n"
+        "0 2 10 3\n1 2 10 3\n2 2 10 3\n"
+        "1 0 0 0 20 2 2 2 2\n");
+    ScoreEvaluator eval(net);
+
+    EXPECT_EQ(eval.evaluateOutput("1 2\n0 2 2 10\n1 2 2 10\n").violations, 0);
+
+    const ScoreReport report = eval.evaluateOutput("1 2\n0 2 2 10\n1 1 1 10\n");
+    EXPECT_EQ(report.violations, 1);
+    EXPECT_NE(report.firstViolation.find("landing outside"), std::string::npos);
+}
+
+TEST(ScoreEvaluatorTest, FlagsTrafficAboveQTotal) {
+    const Network net = load(kExampleInput);
+    ScoreEvaluator eval(net);
+
+    // 流 2 的 Q_total 为 20，传了 25（t=4 时 (0,1) 带宽为 B/2 = 5）
+    const ScoreReport report = eval.evaluateOutput("2 3\n2 0 1 10\n3 0 2 10\n4 0 1 5\n");
+    EXPECT_EQ(report.violations, 1);
+    EXPECT_NE(report.firstViolation.find("more than Q_total"), std::string::npos);
+    EXPECT_DOUBLE_EQ(report.flows[1].traffic, 1.0);   // U2G 得分封顶为 1
+}
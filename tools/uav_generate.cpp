@@ -0,0 +1,155 @@
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "InstanceGenerator.h"
+
+/**
+ * 合成输入实例生成工具
+ *
+ *   uav_generate [选项]                     → 输出单个实例到 stdout
+ *   uav_generate -o file.txt [选项]         → 输出单个实例到文件
+ *   uav_generate -o dir/ --count K [选项]   → 在 dir 下生成 gen_<seed>.txt（seed, seed+1, …），
+ *                                             可直接作为 uav_scheduler -i 的输入目录
+ */
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void printUsage(const char* prog) {
+    std::cout
+        << "用法: " << prog << " [选项]\n"
+        << "  -o PATH             输出文件；配合 --count 时为输出目录（默认 stdout）\n"
+        << "  --count K           生成 K 个实例（seed 依次递增）\n"
+        << "  --seed S            随机种子（默认 42）\n"
+        << "  --max-spec          以题目上限为基准：69x69、FN=4999、T=499\n"
+        << "  --grid MxN          网格尺寸\n"
+        << "  --flows FN          流数量\n"
+        << "  --time T            时长\n"
+        << "  --phases K          相位取值 [0,K)（1~10）\n"
+        << "  --phase-block S     相位按 SxS 方块共享\n"
+        << "  --bw MIN:MAX        峰值带宽区间\n"
+        << "  --bw-skew X         带宽偏斜（>1 偏小）\n"
+        << "  --start-max T       最晚开始时间\n"
+        << "  --start-skew X      开始时间偏斜（>1 集中在开头）\n"
+        << "  --size MIN:MAX      流量区间\n"
+        << "  --landing MIN:MAX   落地区域边长区间\n"
+        << "  --distance MIN:MAX  接入点到落地区域的曼哈顿距离区间\n"
+        << "  --corridor W        只保留各流路线两侧 W 格内的带宽\n";
+}
+
+bool parseInt(const std::string& text, int& out) {
+    char* end = nullptr;
+    const long v = std::strtol(text.c_str(), &end, 10);
+    if (end == text.c_str() || *end != '\0') return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+bool parseDouble(const std::string& text, double& out) {
+    char* end = nullptr;
+    const double v = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || *end != '\0') return false;
+    out = v;
+    return true;
+}
+
+// "A:B" 或单个值 "A"（等价于 A:A）
+template <typename T, typename Parse>
+bool parseRange(const std::string& text, T& lo, T& hi, Parse parse) {
+    const size_t colon = text.find(':');
+    if (colon == std::string::npos) {
+        if (!parse(text, lo)) return false;
+        hi = lo;
+        return true;
+    }
+    return parse(text.substr(0, colon), lo) && parse(text.substr(colon + 1), hi);
+}
+
+bool parseGrid(const std::string& text, int& m, int& n) {
+    const size_t x = text.find_first_of("xX");
+    if (x == std::string::npos) {
+        if (!parseInt(text, m)) return false;
+        n = m;
+        return true;
+    }
+    return parseInt(text.substr(0, x), m) && parseInt(text.substr(x + 1), n);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    GeneratorSpec spec;
+    std::string outPath;
+    int count = 0;
+
+    // --max-spec 作为基准，其它选项在其上覆盖，与出现顺序无关
+    for (int i = 1; i < argc; ++i)
+        if (std::string(argv[i]) == "--max-spec") spec = GeneratorSpec::maxSpec();
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--max-spec") continue;
+        if (arg == "-h" || arg == "--help") { printUsage(argv[0]); return 0; }
+        if (i + 1 >= argc) { printUsage(argv[0]); return 1; }
+        const std::string value = argv[++i];
+
+        bool ok = true;
+        int seed = 0;
+        if      (arg == "-o")             outPath = value;
+        else if (arg == "--count")        ok = parseInt(value, count) && count > 0;
+        else if (arg == "--seed")         { ok = parseInt(value, seed) && seed >= 0; spec.seed = static_cast<uint32_t>(seed); }
+        else if (arg == "--grid")         ok = parseGrid(value, spec.M, spec.N);
+        else if (arg == "--flows")        ok = parseInt(value, spec.flows);
+        else if (arg == "--time")         ok = parseInt(value, spec.T);
+        else if (arg == "--phases")       ok = parseInt(value, spec.phaseCount);
+        else if (arg == "--phase-block")  ok = parseInt(value, spec.phaseBlock);
+        else if (arg == "--bw")           ok = parseRange(value, spec.bMin, spec.bMax, parseDouble);
+        else if (arg == "--bw-skew")      ok = parseDouble(value, spec.bSkew);
+        else if (arg == "--start-max")    ok = parseInt(value, spec.startMax);
+        else if (arg == "--start-skew")   ok = parseDouble(value, spec.startSkew);
+        else if (arg == "--size")         ok = parseRange(value, spec.sizeMin, spec.sizeMax, parseDouble);
+        else if (arg == "--landing")      ok = parseRange(value, spec.landingMin, spec.landingMax, parseInt);
+        else if (arg == "--distance")     ok = parseRange(value, spec.distanceMin, spec.distanceMax, parseInt);
+        else if (arg == "--corridor")     ok = parseInt(value, spec.corridor);
+        else                              ok = false;
+
+        if (!ok) {
+            std::cerr << "❌ 无效参数: " << arg << " " << value << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (spec.M >= 70 || spec.N >= 70 || spec.flows >= 5000 || spec.T >= 500)
+        std::cerr << "⚠️ 超出题目规模上限（M,N<70，FN<5000，T<500）\n";
+
+    if (count == 0) {
+        if (outPath.empty()) {
+            InstanceGenerator::writeInput(InstanceGenerator(spec).generate(), std::cout);
+            return 0;
+        }
+        if (!InstanceGenerator(spec).writeFile(outPath)) {
+            std::cerr << "❌ Cannot open output file: " << outPath << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (outPath.empty()) outPath = ".";
+    std::error_code ec;
+    fs::create_directories(outPath, ec);
+    const uint32_t firstSeed = spec.seed;
+    for (int k = 0; k < count; ++k) {
+        spec.seed = firstSeed + static_cast<uint32_t>(k);
+        const std::string path = (fs::path(outPath) / ("gen_" + std::to_string(spec.seed) + ".txt")).string();
+        if (!InstanceGenerator(spec).writeFile(path)) {
+            std::cerr << "❌ Cannot open output file: " << path << "\n";
+            return 1;
+        }
+        std::cout << "✅ " << path << "\n";
+    }
+    return 0;
+}
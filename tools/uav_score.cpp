@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ScoreEvaluator.h"
+#include "ThreadPool.h"
+#include "Utils.h"
+
+/**
+ * 官方评分工具：按题目评分公式给已保存的输出打分并校验合法性
+ *
+ *   uav_score input.txt output.txt               → 单个实例
+ *   uav_score [-i 输入目录] [-o 输出目录] [-j N] → 批量：input/xxx.txt 对应 output/xxx_result.txt
+ *
+ * 存在不合法记录或文件缺失时返回非零。
+ */
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Row {
+    std::string name;
+    bool ok{false};
+    ScoreReport report;
+};
+
+Row scoreOne(const std::string& inputPath, const std::string& outputPath) {
+    Row row;
+    row.name = fs::path(inputPath).filename().string();
+    Network network;
+    if (Utils::loadNetworkFromFile(inputPath, network))
+        row.ok = Utils::scoreOutputFile(network, outputPath, row.report);
+    return row;
+}
+
+void printUsage(const char* prog) {
+    std::cout << "用法: " << prog << " input.txt output.txt\n"
+              << "      " << prog << " [-i 输入目录] [-o 输出目录] [-j 并发数]\n"
+              << "  默认: -i ../input -o ../output -j <硬件线程数>\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string inputDir = "../input", outputDir = "../output";
+    int workers = ThreadPool::hardwareThreads();
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") { printUsage(argv[0]); return 0; }
+        if ((arg == "-i" || arg == "-o" || arg == "-j") && i + 1 < argc) {
+            const std::string value = argv[++i];
+            if (arg == "-i") inputDir = value;
+            else if (arg == "-o") outputDir = value;
+            else workers = std::max(1, std::atoi(value.c_str()));
+        } else if (!arg.empty() && arg[0] != '-') {
+            positional.push_back(arg);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string>> jobs;   // (输入, 输出)
+    if (positional.size() == 2) {
+        jobs.emplace_back(positional[0], positional[1]);
+    } else if (positional.empty()) {
+        auto files = Utils::listInputFiles(inputDir);
+        std::sort(files.begin(), files.end());
+        for (const auto& f : files)
+            jobs.emplace_back(f, Utils::makeOutputPath(f, inputDir, outputDir));
+    } else {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (jobs.empty()) {
+        std::cerr << "❌ 未找到输入文件\n";
+        return 1;
+    }
+
+    std::vector<Row> rows(jobs.size());
+    ThreadPool pool(std::min<int>(workers, static_cast<int>(jobs.size())));
+    pool.parallelFor(static_cast<int>(jobs.size()), [&](int i) {
+        rows[i] = scoreOne(jobs[i].first, jobs[i].second);
+    });
+
+    size_t nameWidth = 4;
+    for (const auto& r : rows) nameWidth = std::max(nameWidth, r.name.size());
+
+    std::ostringstream oss;
+    oss << std::left << std::setw(static_cast<int>(nameWidth)) << "File"
+        << std::right << std::setw(10) << "Score" << std::setw(8) << "Flows"
+        << std::setw(12) << "Violations" << "\n";
+
+    int failed = 0, scored = 0;
+    double sum = 0.0;
+    for (const auto& r : rows) {
+        oss << std::left << std::setw(static_cast<int>(nameWidth)) << r.name << std::right;
+        if (!r.ok) {
+            oss << std::setw(10) << "-" << std::setw(8) << "-" << std::setw(12) << "-" << "  (missing/unreadable)\n";
+            ++failed;
+            continue;
+        }
+        oss << std::fixed << std::setprecision(3) << std::setw(10) << r.report.total
+            << std::setw(8) << r.report.flows.size()
+            << std::setw(12) << r.report.violations;
+        if (r.report.violations > 0) {
+            oss << "  " << r.report.firstViolation;
+            ++failed;
+        }
+        oss << "\n";
+        sum += r.report.total;
+        ++scored;
+    }
+    oss << "平均得分 " << std::fixed << std::setprecision(3) << (scored > 0 ? sum / scored : 0.0)
+        << "（" << rows.size() - failed << "/" << rows.size() << " 合法）\n";
+    std::cout << oss.str();
+    return failed == 0 ? 0 : 1;
+}